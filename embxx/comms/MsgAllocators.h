@@ -52,6 +52,45 @@ class InPlaceMsgAllocator : public embxx::util::SpecificInPlaceAllocator<TAllMes
 {
 };
 
+/// @brief Message object allocation policy that uses "in place" object
+///        construction in one of multiple slots.
+/// @details Similar to InPlaceMsgAllocator, but creates internal allocation
+///          space for TSlotsCount messages, so multiple decoded messages
+///          may be kept at the same time, for example when they are queued
+///          for processing by other event loops. Every slot is big enough
+///          to contain any of the messages in TAllMessages. The free slots
+///          are linked in the free list, so allocation and deallocation are
+///          O(1) operations.
+/// @tparam TAllMessages std::tuple<...> with all the types of messages this
+///          allocator can allocate
+/// @tparam TSlotsCount Number of messages that may be allocated at the
+///          same time.
+/// @headerfile embxx/comms/MsgAllocators.h
+template <typename TAllMessages, std::size_t TSlotsCount>
+class MultiSlotInPlaceMsgAllocator :
+    public embxx::util::SpecificMultiSlotInPlaceAllocator<TAllMessages, TSlotsCount>
+{
+};
+
+/// @brief Message object allocation policy that uses "in place" object
+///        construction in the pools of different size classes.
+/// @details Groups the messages into size classes, every class has its own
+///          pool of fixed size slots. The size class for every message
+///          type is selected at compile time, when embxx::comms::protocol::MsgIdLayer
+///          instantiates its message factories. It allows significant
+///          reduction of the required RAM when sizes of the messages differ
+///          a lot. See embxx::util::SizeClassInPlaceAllocator for details.
+/// @tparam TAllMessages std::tuple<...> with all the types of messages this
+///          allocator can allocate
+/// @tparam TSizeClasses std::tuple<...> of embxx::util::SizeClass definitions,
+///         sorted in ascending order of the maximal size.
+/// @headerfile embxx/comms/MsgAllocators.h
+template <typename TAllMessages, typename TSizeClasses>
+class SizeClassInPlaceMsgAllocator :
+    public embxx::util::SizeClassInPlaceAllocator<TAllMessages, TSizeClasses>
+{
+};
+
 }  // namespace comms
 
 }  // namespace embxx
@@ -0,0 +1,331 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/container/MpmcStaticQueue.h
+/// This file contains the definition and implementation of the bounded
+/// static queue that allows concurrent access of multiple producers and
+/// multiple consumers without any locking.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+
+#include "embxx/util/Assert.h"
+#include "embxx/util/ScopeGuard.h"
+
+namespace embxx
+{
+
+namespace container
+{
+
+/// @addtogroup container
+/// @{
+
+/// @brief Static queue for multiple producers and multiple consumers.
+/// @details The elements are stored in place (no dynamic memory allocation),
+///          constructed when pushed and destructed when popped, just
+///          like in embxx::container::StaticQueue. Every cell of the
+///          internal storage is accompanied by atomic sequence number,
+///          that tells the producers and consumers whether the cell
+///          is available for writing or reading in the current pass over
+///          the storage area. As the result the threads contend only on
+///          the atomic increment of the front or back positions and never
+///          wait for each other while constructing or moving out the
+///          elements.
+///
+///          The queue is intended to be used on multi-core hosts, where
+///          the std::mutex protected StaticQueue doesn't scale beyond
+///          a couple of threads. The front and back positions are kept
+///          on separate cache lines to avoid false sharing.
+/// @tparam T Type of the stored element. Its constructors used when
+///         pushing and its move assignment operator used when popping
+///         are not expected to throw. If the constructor throws anyway,
+///         the already claimed cell is published as empty and skipped
+///         by the consumers.
+/// @tparam TSize Maximum number of stored elements, must be a power of two.
+/// @headerfile embxx/container/MpmcStaticQueue.h
+template <typename T, std::size_t TSize>
+class MpmcStaticQueue
+{
+    static_assert((TSize != 0) && ((TSize & (TSize - 1)) == 0),
+        "The capacity of the queue must be a power of two");
+
+    typedef
+        typename std::aligned_storage<
+            sizeof(T),
+            std::alignment_of<T>::value
+        >::type StorageType;
+
+public:
+    /// @brief Type of the stored elements.
+    typedef T ValueType;
+
+    /// @brief Same as ValueType
+    typedef ValueType value_type;
+
+    /// @brief Size type.
+    typedef std::size_t SizeType;
+
+    /// @brief Same as SizeType
+    typedef SizeType size_type;
+
+    /// @brief Reference type to the stored elements.
+    typedef ValueType& Reference;
+
+    /// @brief Same as Reference
+    typedef Reference reference;
+
+    /// @brief Default constructor.
+    /// @details Creates empty queue.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    MpmcStaticQueue();
+
+    /// @brief Copy constructor is deleted
+    MpmcStaticQueue(const MpmcStaticQueue&) = delete;
+
+    /// @brief Destructor
+    /// @details Destructs all the elements remaining in the queue.
+    /// @note Thread safety: Unsafe
+    ~MpmcStaticQueue();
+
+    /// @brief Copy assignment operator is deleted
+    MpmcStaticQueue& operator=(const MpmcStaticQueue&) = delete;
+
+    /// @brief Returns capacity of the queue.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    static constexpr std::size_t capacity()
+    {
+        return TSize;
+    }
+
+    /// @brief Returns approximate number of elements in the queue.
+    /// @details The value may be outdated by the time it is returned
+    ///          if other threads are accessing the queue.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    std::size_t size() const;
+
+    /// @brief Returns whether the queue is empty.
+    /// @details Same approximation as size().
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    bool empty() const;
+
+    /// @brief Add new element to the end of the queue.
+    /// @details Uses copy/move constructor of the stored type.
+    /// @param[in] value R-value or L-value reference to the element.
+    /// @return true in case the element was added, false if the queue is full.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw in case the constructor of the
+    ///       element doesn't throw.
+    template <typename U>
+    bool pushBack(U&& value);
+
+    /// @brief Construct new element at the end of the queue.
+    /// @param[in] args Arguments for the constructor of the element.
+    /// @return true in case the element was added, false if the queue is full.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw in case the constructor of the
+    ///       element doesn't throw.
+    template <typename... TArgs>
+    bool emplaceBack(TArgs&&... args);
+
+    /// @brief Move the element from the front of the queue and pop it.
+    /// @param[out] value Reference to the object to move the element into.
+    /// @return true in case the element was popped, false if the queue
+    ///         is empty.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw in case the move assignment
+    ///       operator and destructor of the element don't throw.
+    bool popFront(ValueType& value);
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> seq_;
+        bool constructed_;
+        StorageType storage_;
+    };
+
+    static const std::size_t CacheLineSize = 64;
+    static const std::size_t Mask = TSize - 1;
+
+    typedef std::array<Cell, TSize> Cells;
+
+    Reference elementAt(Cell& cell);
+
+    Cells cells_;
+    char headPad_[CacheLineSize];
+    std::atomic<std::size_t> head_;
+    char tailPad_[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> tail_;
+    char endPad_[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+};
+
+/// @}
+
+// Implementation
+template <typename T, std::size_t TSize>
+MpmcStaticQueue<T, TSize>::MpmcStaticQueue()
+    : head_(0),
+      tail_(0)
+{
+    for (auto idx = 0U; idx < TSize; ++idx) {
+        cells_[idx].seq_.store(idx, std::memory_order_relaxed);
+        cells_[idx].constructed_ = false;
+    }
+}
+
+template <typename T, std::size_t TSize>
+MpmcStaticQueue<T, TSize>::~MpmcStaticQueue()
+{
+    auto head = head_.load(std::memory_order_relaxed);
+    auto tail = tail_.load(std::memory_order_relaxed);
+    for (; head != tail; ++head) {
+        auto& cell = cells_[head & Mask];
+        GASSERT(cell.seq_.load(std::memory_order_relaxed) == (head + 1));
+        if (cell.constructed_) {
+            elementAt(cell).~T();
+        }
+    }
+}
+
+template <typename T, std::size_t TSize>
+std::size_t MpmcStaticQueue<T, TSize>::size() const
+{
+    auto head = head_.load(std::memory_order_relaxed);
+    auto tail = tail_.load(std::memory_order_relaxed);
+    auto diff = static_cast<std::ptrdiff_t>(tail - head);
+    if (diff <= 0) {
+        return 0;
+    }
+
+    if (static_cast<std::size_t>(diff) < TSize) {
+        return static_cast<std::size_t>(diff);
+    }
+
+    return TSize;
+}
+
+template <typename T, std::size_t TSize>
+bool MpmcStaticQueue<T, TSize>::empty() const
+{
+    return size() == 0;
+}
+
+template <typename T, std::size_t TSize>
+template <typename U>
+bool MpmcStaticQueue<T, TSize>::pushBack(U&& value)
+{
+    return emplaceBack(std::forward<U>(value));
+}
+
+template <typename T, std::size_t TSize>
+template <typename... TArgs>
+bool MpmcStaticQueue<T, TSize>::emplaceBack(TArgs&&... args)
+{
+    auto pos = tail_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+        cell = &cells_[pos & Mask];
+        auto seq = cell->seq_.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+            continue; // pos is updated by compare_exchange_weak
+        }
+
+        if (diff < 0) {
+            return false; // full
+        }
+
+        pos = tail_.load(std::memory_order_relaxed);
+    }
+
+    // The cell is claimed, it must be published even if the constructor
+    // throws, otherwise the consumers stall on it.
+    cell->constructed_ = false;
+    auto guard = embxx::util::makeScopeGuard(
+        [cell, pos]()
+        {
+            cell->seq_.store(pos + 1, std::memory_order_release);
+        });
+
+    auto elementPtr = new (&cell->storage_) ValueType(std::forward<TArgs>(args)...);
+    static_cast<void>(elementPtr);
+    cell->constructed_ = true;
+    return true;
+}
+
+template <typename T, std::size_t TSize>
+bool MpmcStaticQueue<T, TSize>::popFront(ValueType& value)
+{
+    auto pos = head_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+        cell = &cells_[pos & Mask];
+        auto seq = cell->seq_.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+        if (diff == 0) {
+            if (!head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                continue; // pos is updated by compare_exchange_weak
+            }
+
+            if (cell->constructed_) {
+                break;
+            }
+
+            // Construction of the element has thrown, skip the cell
+            cell->seq_.store(pos + TSize, std::memory_order_release);
+            pos = head_.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (diff < 0) {
+            return false; // empty
+        }
+
+        pos = head_.load(std::memory_order_relaxed);
+    }
+
+    auto& element = elementAt(*cell);
+    value = std::move(element);
+    element.~T();
+    cell->seq_.store(pos + TSize, std::memory_order_release);
+    return true;
+}
+
+template <typename T, std::size_t TSize>
+typename MpmcStaticQueue<T, TSize>::Reference
+MpmcStaticQueue<T, TSize>::elementAt(Cell& cell)
+{
+    return reinterpret_cast<Reference>(cell.storage_);
+}
+
+}  // namespace container
+
+}  // namespace embxx
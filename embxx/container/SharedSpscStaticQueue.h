@@ -0,0 +1,205 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/container/SharedSpscStaticQueue.h
+/// This file contains the definition and implementation of the single
+/// producer / single consumer static queue that may be placed in the memory
+/// shared between processes.
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+
+#include "embxx/util/Assert.h"
+#include "SpscStaticQueue.h"
+
+namespace embxx
+{
+
+namespace container
+{
+
+/// @addtogroup container
+/// @{
+
+/// @brief Single producer / single consumer static queue for the memory
+///        shared between processes.
+/// @details Extends embxx::container::SpscStaticQueue, which keeps both the
+///          storage area and the atomic front / back positions inside the
+///          object and doesn't contain any pointers. Hence the object is
+///          position independent and may be constructed in the region
+///          created by shm_open() / mmap() and mapped to different addresses
+///          in the producer and consumer processes. The stored elements
+///          must be trivially copyable, i.e. must not contain pointers
+///          or any other process specific resources.
+///
+///          On top of the lock-free index protocol of the base class this
+///          queue provides the protocol of waking up the sleeping consumer.
+///          The consumer marks itself as waiting before going to sleep and
+///          the producer invokes the provided notification functor only
+///          when the consumer is waiting, i.e. there is no system call for
+///          every pushed element. The actual wake up mechanism (such as
+///          eventfd, see embxx::util::EventFdNotifier) is provided by
+///          the caller, because its handles are process specific and cannot
+///          be stored in the shared memory.
+/// @tparam T Type of the stored element, must be trivially copyable.
+/// @tparam TSize Maximum number of stored elements.
+/// @headerfile embxx/container/SharedSpscStaticQueue.h
+template <typename T, std::size_t TSize>
+class SharedSpscStaticQueue : public SpscStaticQueue<T, TSize>
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+        "Only trivially copyable elements may be shared between processes");
+
+    typedef SpscStaticQueue<T, TSize> Base;
+
+public:
+    /// @brief Default constructor.
+    /// @details Creates empty queue. Must be executed only once in the
+    ///          process that creates the shared memory region. The other
+    ///          process casts the mapped address to the queue type.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    SharedSpscStaticQueue();
+
+    /// @brief Check whether the internal atomic variables may be used by
+    ///        multiple processes.
+    /// @details The atomic operations on them must be lock-free, otherwise
+    ///          the lock is process specific.
+    static bool isShareable();
+
+    /// @brief Add new element to the end of the queue and wake up the consumer
+    ///        if it is waiting.
+    /// @param[in] value R-value or L-value reference to the element.
+    /// @param[in] notifyFunc Functor with <b>void ()</b> signature that wakes
+    ///            up the consumer. It is invoked only if the consumer
+    ///            has started waiting for new element.
+    /// @return true in case the element was added, false if the queue is full.
+    /// @note Thread safety: Safe for the producer.
+    /// @note Exception guarantee: Strong
+    template <typename U, typename TNotifyFunc>
+    bool pushBackNotify(U&& value, TNotifyFunc&& notifyFunc);
+
+    /// @brief Publish the element written in place into the cell returned
+    ///        by reserveBack() and wake up the consumer if it is waiting.
+    /// @details Allows the producer to build the element directly in the
+    ///          shared memory region without copying it.
+    /// @param[in] notifyFunc Functor with <b>void ()</b> signature that wakes
+    ///            up the consumer. It is invoked only if the consumer
+    ///            has started waiting for new element.
+    /// @pre reserveBack() has returned valid cell.
+    /// @note Thread safety: Safe for the producer.
+    /// @note Exception guarantee: Strong
+    template <typename TNotifyFunc>
+    void commitBackNotify(TNotifyFunc&& notifyFunc);
+
+    /// @brief Wait until the queue is not empty.
+    /// @details If the queue is empty, marks the consumer as waiting and
+    ///          invokes the provided functor that is expected to block
+    ///          until the notification functor passed to pushBackNotify()
+    ///          is invoked by the producer. Spurious wake ups are allowed,
+    ///          the functor is invoked again if the queue is still empty.
+    /// @param[in] waitFunc Functor with <b>void ()</b> signature.
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: Basic
+    template <typename TWaitFunc>
+    void waitNotEmpty(TWaitFunc&& waitFunc);
+
+private:
+    template <typename TNotifyFunc>
+    void notifyConsumer(TNotifyFunc&& notifyFunc);
+
+    std::atomic<bool> consumerWaiting_;
+};
+
+/// @}
+
+// Implementation
+template <typename T, std::size_t TSize>
+SharedSpscStaticQueue<T, TSize>::SharedSpscStaticQueue()
+    : consumerWaiting_(false)
+{
+    GASSERT(isShareable());
+}
+
+template <typename T, std::size_t TSize>
+bool SharedSpscStaticQueue<T, TSize>::isShareable()
+{
+    std::atomic<std::size_t> index(0);
+    std::atomic<bool> flag(false);
+    return index.is_lock_free() && flag.is_lock_free();
+}
+
+template <typename T, std::size_t TSize>
+template <typename U, typename TNotifyFunc>
+bool SharedSpscStaticQueue<T, TSize>::pushBackNotify(
+    U&& value,
+    TNotifyFunc&& notifyFunc)
+{
+    if (!Base::pushBack(std::forward<U>(value))) {
+        return false;
+    }
+
+    notifyConsumer(std::forward<TNotifyFunc>(notifyFunc));
+    return true;
+}
+
+template <typename T, std::size_t TSize>
+template <typename TNotifyFunc>
+void SharedSpscStaticQueue<T, TSize>::commitBackNotify(
+    TNotifyFunc&& notifyFunc)
+{
+    Base::commitBack();
+    notifyConsumer(std::forward<TNotifyFunc>(notifyFunc));
+}
+
+template <typename T, std::size_t TSize>
+template <typename TWaitFunc>
+void SharedSpscStaticQueue<T, TSize>::waitNotEmpty(TWaitFunc&& waitFunc)
+{
+    while (Base::empty()) {
+        consumerWaiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!Base::empty()) {
+            consumerWaiting_.store(false, std::memory_order_relaxed);
+            break;
+        }
+
+        waitFunc();
+    }
+}
+
+template <typename T, std::size_t TSize>
+template <typename TNotifyFunc>
+void SharedSpscStaticQueue<T, TSize>::notifyConsumer(
+    TNotifyFunc&& notifyFunc)
+{
+    // Pairs with the fence in waitNotEmpty(): either the consumer sees
+    // the new element or the producer sees the waiting consumer.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumerWaiting_.load(std::memory_order_relaxed)) {
+        consumerWaiting_.store(false, std::memory_order_relaxed);
+        notifyFunc();
+    }
+}
+
+}  // namespace container
+
+}  // namespace embxx
@@ -0,0 +1,682 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/container/SpscStaticQueue.h
+/// This file contains the definition and implementation of the static queue
+/// that allows concurrent access of single producer and single consumer
+/// without any locking.
+
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+#include "embxx/util/Assert.h"
+
+namespace embxx
+{
+
+namespace container
+{
+
+namespace details
+{
+
+template <typename TQueue, typename TValue>
+class SpscStaticQueueIterator
+{
+    template <typename TOtherQueue, typename TOtherValue>
+    friend class SpscStaticQueueIterator;
+
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef typename std::remove_const<TValue>::type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef TValue* pointer;
+    typedef TValue& reference;
+
+    SpscStaticQueueIterator(TQueue& queue, std::size_t idx)
+        : queue_(&queue),
+          idx_(idx)
+    {
+    }
+
+    template <typename TOtherQueue, typename TOtherValue>
+    SpscStaticQueueIterator(
+        const SpscStaticQueueIterator<TOtherQueue, TOtherValue>& other)
+        : queue_(other.queue_),
+          idx_(other.idx_)
+    {
+    }
+
+    SpscStaticQueueIterator(const SpscStaticQueueIterator&) = default;
+    SpscStaticQueueIterator& operator=(const SpscStaticQueueIterator&) = default;
+
+    SpscStaticQueueIterator& operator++()
+    {
+        ++idx_;
+        return *this;
+    }
+
+    SpscStaticQueueIterator operator++(int)
+    {
+        auto tmp = *this;
+        ++idx_;
+        return tmp;
+    }
+
+    SpscStaticQueueIterator& operator--()
+    {
+        --idx_;
+        return *this;
+    }
+
+    SpscStaticQueueIterator operator--(int)
+    {
+        auto tmp = *this;
+        --idx_;
+        return tmp;
+    }
+
+    SpscStaticQueueIterator& operator+=(difference_type value)
+    {
+        idx_ += value;
+        return *this;
+    }
+
+    SpscStaticQueueIterator& operator-=(difference_type value)
+    {
+        idx_ -= value;
+        return *this;
+    }
+
+    SpscStaticQueueIterator operator+(difference_type value) const
+    {
+        auto tmp = *this;
+        tmp += value;
+        return tmp;
+    }
+
+    SpscStaticQueueIterator operator-(difference_type value) const
+    {
+        auto tmp = *this;
+        tmp -= value;
+        return tmp;
+    }
+
+    difference_type operator-(const SpscStaticQueueIterator& other) const
+    {
+        GASSERT(queue_ == other.queue_);
+        return static_cast<difference_type>(idx_) -
+               static_cast<difference_type>(other.idx_);
+    }
+
+    bool operator==(const SpscStaticQueueIterator& other) const
+    {
+        return (queue_ == other.queue_) && (idx_ == other.idx_);
+    }
+
+    bool operator!=(const SpscStaticQueueIterator& other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const SpscStaticQueueIterator& other) const
+    {
+        GASSERT(queue_ == other.queue_);
+        return idx_ < other.idx_;
+    }
+
+    bool operator<=(const SpscStaticQueueIterator& other) const
+    {
+        return !(other < *this);
+    }
+
+    bool operator>(const SpscStaticQueueIterator& other) const
+    {
+        return other < *this;
+    }
+
+    bool operator>=(const SpscStaticQueueIterator& other) const
+    {
+        return !(*this < other);
+    }
+
+    reference operator*() const
+    {
+        return (*queue_)[idx_];
+    }
+
+    pointer operator->() const
+    {
+        return &(*queue_)[idx_];
+    }
+
+    reference operator[](difference_type value) const
+    {
+        return (*queue_)[idx_ + value];
+    }
+
+private:
+    TQueue* queue_;
+    std::size_t idx_;
+};
+
+}  // namespace details
+
+/// @addtogroup container
+/// @{
+
+/// @brief Static queue for single producer and single consumer.
+/// @details Similar to embxx::container::StaticQueue, but allows the
+///          producer (interrupt handler or other thread) to push new
+///          elements to the back of the queue while the consumer (for
+///          example event loop) accesses and pops the elements from
+///          the front without any locking or disabling of the interrupts.
+///          The positions of the front and back of the queue are kept
+///          in atomic variables, the producer publishes the new element
+///          with "release" store and the consumer releases the cell
+///          back to the producer the same way.
+///
+///          The producer is allowed to call only pushBack(), emplaceBack(),
+///          reserveBack(), commitBack(), full(), size(), empty() and
+///          capacity(). All the other member
+///          functions are for the consumer. The consumer sees the elements
+///          pushed by the producer at the time of the call, i.e. the size()
+///          may only grow between the consumer calls. It means that the
+///          iteration range (begin(), end()) and the linearised ranges
+///          returned by arrayOne() and arrayTwo() are valid snapshots, but
+///          they are not synchronised with each other. When processing the
+///          linearised ranges, pop the elements of arrayOne() before
+///          calling arrayOne() again: the next range continues at the
+///          beginning of the storage area:
+///          @code
+///          while (!queue.empty()) {
+///              auto range = queue.arrayOne();
+///              auto count = std::distance(range.first, range.second);
+///              process(range.first, count);
+///              queue.popFront(count);
+///          }
+///          @endcode
+/// @tparam T Type of the stored element.
+/// @tparam TSize Maximum number of stored elements.
+/// @headerfile embxx/container/SpscStaticQueue.h
+template <typename T, std::size_t TSize>
+class SpscStaticQueue
+{
+    static_assert(0 < TSize, "The queue must be able to store elements");
+
+    typedef
+        typename std::aligned_storage<
+            sizeof(T),
+            std::alignment_of<T>::value
+        >::type StorageType;
+
+public:
+    /// @brief Type of the stored elements.
+    typedef T ValueType;
+
+    /// @brief Same as ValueType
+    typedef ValueType value_type;
+
+    /// @brief Size type.
+    typedef std::size_t SizeType;
+
+    /// @brief Same as SizeType
+    typedef SizeType size_type;
+
+    /// @brief Reference type to the stored elements.
+    typedef ValueType& Reference;
+
+    /// @brief Same as Reference
+    typedef Reference reference;
+
+    /// @brief Const reference type to the stored elements.
+    typedef const ValueType& ConstReference;
+
+    /// @brief Same as ConstReference
+    typedef ConstReference const_reference;
+
+    /// @brief Pointer type to the stored elements.
+    typedef ValueType* Pointer;
+
+    /// @brief Same as Pointer
+    typedef Pointer pointer;
+
+    /// @brief Const pointer type to the stored elements.
+    typedef const ValueType* ConstPointer;
+
+    /// @brief Same as ConstPointer
+    typedef ConstPointer const_pointer;
+
+    /// @brief Linearised iterator type
+    typedef Pointer LinearisedIterator;
+
+    /// @brief Const linearised iterator type
+    typedef ConstPointer ConstLinearisedIterator;
+
+    /// @brief Linearised iterator range type - std::pair of (first, one-past-last) iterators.
+    typedef std::pair<LinearisedIterator, LinearisedIterator> LinearisedIteratorRange;
+
+    /// @brief Const version of LinearisedIteratorRange
+    typedef std::pair<ConstLinearisedIterator, ConstLinearisedIterator> ConstLinearisedIteratorRange;
+
+    /// @brief Const iterator class
+    typedef details::SpscStaticQueueIterator<const SpscStaticQueue, const ValueType> ConstIterator;
+
+    /// @brief Same as ConstIterator
+    typedef ConstIterator const_iterator;
+
+    /// @brief Iterator class
+    typedef details::SpscStaticQueueIterator<SpscStaticQueue, ValueType> Iterator;
+
+    /// @brief Same as Iterator
+    typedef Iterator iterator;
+
+    /// @brief Default constructor.
+    /// @details Creates empty queue.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    SpscStaticQueue()
+        : head_(0),
+          tail_(0)
+    {
+    }
+
+    /// @brief Copy constructor is deleted
+    SpscStaticQueue(const SpscStaticQueue&) = delete;
+
+    /// @brief Destructor
+    /// @details Destructs all the elements remaining in the queue.
+    /// @note Thread safety: Unsafe
+    ~SpscStaticQueue()
+    {
+        clear();
+    }
+
+    /// @brief Copy assignment operator is deleted
+    SpscStaticQueue& operator=(const SpscStaticQueue&) = delete;
+
+    /// @brief Returns capacity of the queue.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    static constexpr std::size_t capacity()
+    {
+        return TSize;
+    }
+
+    /// @brief Returns current size of the queue.
+    /// @note Thread safety: Safe for the producer and the consumer.
+    /// @note Exception guarantee: No throw
+    std::size_t size() const
+    {
+        return distance(
+            head_.load(std::memory_order_acquire),
+            tail_.load(std::memory_order_acquire));
+    }
+
+    /// @brief Returns whether the queue is empty.
+    /// @note Thread safety: Safe for the producer and the consumer.
+    /// @note Exception guarantee: No throw
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// @brief Returns whether the queue is full.
+    /// @note Thread safety: Safe for the producer and the consumer.
+    /// @note Exception guarantee: No throw
+    bool full() const
+    {
+        return size() == capacity();
+    }
+
+    /// @brief Add new element to the end of the queue.
+    /// @details Uses copy/move constructor of the stored type.
+    /// @param[in] value R-value or L-value reference to the element.
+    /// @return true in case the element was added, false if the queue is full.
+    /// @note Thread safety: Safe for the producer.
+    /// @note Exception guarantee: Strong
+    template <typename U>
+    bool pushBack(U&& value)
+    {
+        return emplaceBack(std::forward<U>(value));
+    }
+
+    /// @brief Same as pushBack(U&&)
+    template <typename U>
+    bool push_back(U&& value)
+    {
+        return pushBack(std::forward<U>(value));
+    }
+
+    /// @brief Construct new element at the end of the queue.
+    /// @param[in] args Arguments for the constructor of the element.
+    /// @return true in case the element was added, false if the queue is full.
+    /// @note Thread safety: Safe for the producer.
+    /// @note Exception guarantee: Strong
+    template <typename... TArgs>
+    bool emplaceBack(TArgs&&... args)
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (distance(head_.load(std::memory_order_acquire), tail) == capacity()) {
+            return false;
+        }
+
+        auto elementPtr =
+            new (&array_[cellIdx(tail)]) ValueType(std::forward<TArgs>(args)...);
+        static_cast<void>(elementPtr);
+        tail_.store(advance(tail, 1), std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Same as emplaceBack()
+    template <typename... TArgs>
+    bool emplace_back(TArgs&&... args)
+    {
+        return emplaceBack(std::forward<TArgs>(args)...);
+    }
+
+    /// @brief Get the cell at the end of the queue to write the next
+    ///        element in place.
+    /// @details The element is not visible to the consumer until
+    ///          commitBack() is called. Available only for trivially
+    ///          copyable element types.
+    /// @return Pointer to the cell, nullptr if the queue is full.
+    /// @post The queue is not modified, calling reserveBack() again
+    ///       returns the same cell.
+    /// @note Thread safety: Safe for the producer.
+    /// @note Exception guarantee: No throw
+    Pointer reserveBack()
+    {
+        static_assert(std::is_trivially_copyable<ValueType>::value,
+            "Only trivially copyable elements can be written in place");
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (distance(head_.load(std::memory_order_acquire), tail) == capacity()) {
+            return nullptr;
+        }
+
+        return reinterpret_cast<Pointer>(&array_[cellIdx(tail)]);
+    }
+
+    /// @brief Publish the element written into the cell returned by
+    ///        reserveBack() to the consumer.
+    /// @pre reserveBack() has returned valid cell.
+    /// @note Thread safety: Safe for the producer.
+    /// @note Exception guarantee: No throw
+    void commitBack()
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        GASSERT(distance(head_.load(std::memory_order_acquire), tail) < capacity());
+        tail_.store(advance(tail, 1), std::memory_order_release);
+    }
+
+    /// @brief Provides reference to the front element.
+    /// @pre The queue is not empty.
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: No throw
+    Reference front()
+    {
+        return (*this)[0];
+    }
+
+    /// @brief Const version of front().
+    ConstReference front() const
+    {
+        return (*this)[0];
+    }
+
+    /// @brief Provides reference to the specified element.
+    /// @param[in] index Index of the element counted from the front.
+    /// @pre @code index < size() @endcode
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: No throw
+    Reference operator[](std::size_t index)
+    {
+        auto constThis = static_cast<const SpscStaticQueue*>(this);
+        return const_cast<Reference>((*constThis)[index]);
+    }
+
+    /// @brief Const version of operator[]().
+    ConstReference operator[](std::size_t index) const
+    {
+        GASSERT(index < size());
+        auto head = head_.load(std::memory_order_relaxed);
+        return elementAt(advance(head, index));
+    }
+
+    /// @brief Pop the element from the front of the queue.
+    /// @details Calls the destructor of the element and makes its cell
+    ///          available to the producer.
+    /// @pre The queue is not empty.
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: No throw
+    void popFront()
+    {
+        popFront(1);
+    }
+
+    /// @brief Same as popFront()
+    void pop_front()
+    {
+        popFront();
+    }
+
+    /// @brief Pop number of the elements from the front of the queue.
+    /// @details All the released cells become available to the producer
+    ///          at once.
+    /// @param[in] count Number of elements to pop.
+    /// @pre @code count <= size() @endcode
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: No throw
+    void popFront(std::size_t count)
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto available = distance(head, tail_.load(std::memory_order_acquire));
+        GASSERT(count <= available);
+        count = std::min(count, available);
+        if (count == 0) {
+            return;
+        }
+
+        for (auto idx = 0U; idx < count; ++idx) {
+            elementAt(advance(head, idx)).~T();
+        }
+        head_.store(advance(head, count), std::memory_order_release);
+    }
+
+    /// @brief Same as popFront(std::size_t)
+    void pop_front(std::size_t count)
+    {
+        popFront(count);
+    }
+
+    /// @brief Clears the queue from all the elements currently in it.
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: No throw
+    void clear()
+    {
+        popFront(size());
+    }
+
+    /// @brief Get the first continuous array of the stored elements.
+    /// @details Returns the range of the elements from the front of the
+    ///          queue to the end of the queue or to the end of the internal
+    ///          storage area whichever comes first.
+    /// @return Pair of pointers, first - pointer to the front element,
+    ///         second - one past the last element of the range.
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: No throw
+    LinearisedIteratorRange arrayOne()
+    {
+        auto constThis = static_cast<const SpscStaticQueue*>(this);
+        auto constRange = constThis->arrayOne();
+        return
+            LinearisedIteratorRange(
+                const_cast<LinearisedIterator>(constRange.first),
+                const_cast<LinearisedIterator>(constRange.second));
+    }
+
+    /// @brief Const version of arrayOne().
+    ConstLinearisedIteratorRange arrayOne() const
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto begIdx = cellIdx(head);
+        auto count = distance(head, tail_.load(std::memory_order_acquire));
+        auto endIdx = std::min(begIdx + count, capacity());
+        return
+            ConstLinearisedIteratorRange(
+                cellPtr(begIdx),
+                cellPtr(endIdx));
+    }
+
+    /// @brief Get the second continuous array of the stored elements.
+    /// @details Returns the range of the elements that wrapped around
+    ///          the end of the internal storage area. If there are
+    ///          no such elements, the returned range is empty and both
+    ///          of its iterators are equal to the end of arrayOne().
+    /// @return Pair of pointers, first - pointer to the first element of
+    ///         the range, second - one past the last element of the range.
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: No throw
+    LinearisedIteratorRange arrayTwo()
+    {
+        auto constThis = static_cast<const SpscStaticQueue*>(this);
+        auto constRange = constThis->arrayTwo();
+        return
+            LinearisedIteratorRange(
+                const_cast<LinearisedIterator>(constRange.first),
+                const_cast<LinearisedIterator>(constRange.second));
+    }
+
+    /// @brief Const version of arrayTwo().
+    ConstLinearisedIteratorRange arrayTwo() const
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto begIdx = cellIdx(head);
+        auto count = distance(head, tail_.load(std::memory_order_acquire));
+        if ((begIdx + count) <= capacity()) {
+            auto iter = cellPtr(begIdx + count);
+            return ConstLinearisedIteratorRange(iter, iter);
+        }
+
+        return
+            ConstLinearisedIteratorRange(
+                cellPtr(0),
+                cellPtr((begIdx + count) - capacity()));
+    }
+
+    /// @brief Returns iterator to the front element.
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: No throw
+    Iterator begin()
+    {
+        return Iterator(*this, 0);
+    }
+
+    /// @brief Same as cbegin()
+    ConstIterator begin() const
+    {
+        return cbegin();
+    }
+
+    /// @brief Const version of begin()
+    ConstIterator cbegin() const
+    {
+        return ConstIterator(*this, 0);
+    }
+
+    /// @brief Returns iterator to the end of the elements pushed
+    ///        at the time of the call.
+    /// @note Thread safety: Safe for the consumer.
+    /// @note Exception guarantee: No throw
+    Iterator end()
+    {
+        return Iterator(*this, size());
+    }
+
+    /// @brief Same as cend()
+    ConstIterator end() const
+    {
+        return cend();
+    }
+
+    /// @brief Const version of end()
+    ConstIterator cend() const
+    {
+        return ConstIterator(*this, size());
+    }
+
+private:
+    static std::size_t advance(std::size_t pos, std::size_t count)
+    {
+        pos += count;
+        if ((2 * capacity()) <= pos) {
+            pos -= 2 * capacity();
+        }
+        return pos;
+    }
+
+    static std::size_t distance(std::size_t from, std::size_t to)
+    {
+        if (from <= to) {
+            return to - from;
+        }
+        return ((2 * capacity()) - from) + to;
+    }
+
+    static std::size_t cellIdx(std::size_t pos)
+    {
+        if (pos < capacity()) {
+            return pos;
+        }
+        return pos - capacity();
+    }
+
+    ConstPointer cellPtr(std::size_t idx) const
+    {
+        return reinterpret_cast<ConstPointer>(&array_[0] + idx);
+    }
+
+    ConstReference elementAt(std::size_t pos) const
+    {
+        return *cellPtr(cellIdx(pos));
+    }
+
+    Reference elementAt(std::size_t pos)
+    {
+        return const_cast<Reference>(
+            static_cast<const SpscStaticQueue*>(this)->elementAt(pos));
+    }
+
+    // Positions are kept in range [0, 2 * TSize) to distinguish full queue
+    // from empty one without wasting a cell.
+    std::array<StorageType, TSize> array_;
+    std::atomic<std::size_t> head_;
+    std::atomic<std::size_t> tail_;
+};
+
+/// @}
+
+}  // namespace container
+
+}  // namespace embxx
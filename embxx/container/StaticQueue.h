@@ -23,6 +23,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 #include <array>
 #include <string>
 #include <stdexcept>
@@ -43,7 +44,13 @@ namespace container
 namespace details
 {
 
-template <typename T>
+template <std::size_t TSize>
+struct StaticQueueIsPowerOfTwo
+{
+    static const bool value = (TSize != 0) && ((TSize & (TSize - 1)) == 0);
+};
+
+template <typename T, bool TPowerOfTwo = false>
 class StaticQueueBase
 {
 public:
@@ -73,6 +80,8 @@ protected:
     typedef std::reverse_iterator<ConstLinearisedIterator> ConstReverseLinearisedIterator;
     typedef std::pair<LinearisedIterator, LinearisedIterator> LinearisedIteratorRange;
     typedef std::pair<ConstLinearisedIterator, ConstLinearisedIterator> ConstLinearisedIteratorRange;
+    typedef std::pair<Pointer, std::size_t> ContiguousRegion;
+    typedef std::pair<ConstPointer, std::size_t> ConstContiguousRegion;
 
     StaticQueueBase(StorageTypePtr data, std::size_t cap)
         : data_(data),
@@ -124,9 +133,7 @@ protected:
 
     void clear()
     {
-        while (!empty()) {
-            popFront();
-        }
+        popFront(size());
     }
 
     bool empty() const
@@ -181,20 +188,21 @@ protected:
         element.~T();
 
         --count_;
-        ++startIdx_;
-        if ((capacity() <= startIdx_) ||
-            (empty())) {
-            startIdx_ = 0;
-        }
+        startIdx_ = rawIndex(1);
     }
 
     void popFront(std::size_t count)
     {
         GASSERT(count <= size());
-        while ((!empty()) && (count > 0)) {
-            popFront();
-            --count;
-        }
+        popFrontElements(std::min(count, size()), DestructTag());
+    }
+
+    void popFront(Pointer values, std::size_t count)
+    {
+        GASSERT(count <= size());
+        count = std::min(count, size());
+        copyFrontElements(values, count, CopyTag());
+        popFrontElements(count, DestructTag());
     }
 
     void popBack()
@@ -215,10 +223,7 @@ protected:
     void popBack(std::size_t count)
     {
         GASSERT(count <= size());
-        while ((!empty()) && (count > 0)) {
-            popBack();
-            --count;
-        }
+        popBackElements(std::min(count, size()), DestructTag());
     }
 
     Reference operator[](std::size_t index)
@@ -472,6 +477,39 @@ protected:
                 reinterpret_cast<ConstLinearisedIterator>(endCell));
     }
 
+    ContiguousRegion reserveContiguous(std::size_t maxCount)
+    {
+        static_assert(std::is_trivially_copyable<ValueType>::value,
+            "Only trivially copyable elements can be written in place");
+        rehomeIfEmpty();
+        auto cellPtr = &data_[rawIndex(size())];
+        return ContiguousRegion(
+            reinterpret_cast<Pointer>(cellPtr),
+            std::min(maxCount, contiguousSpace()));
+    }
+
+    void commit(std::size_t count)
+    {
+        GASSERT(count <= contiguousSpace());
+        count_ += std::min(count, contiguousSpace());
+    }
+
+    ContiguousRegion peekContiguous()
+    {
+        auto range = arrayOne();
+        return ContiguousRegion(
+            range.first,
+            static_cast<std::size_t>(std::distance(range.first, range.second)));
+    }
+
+    ConstContiguousRegion peekContiguous() const
+    {
+        auto range = arrayOne();
+        return ConstContiguousRegion(
+            range.first,
+            static_cast<std::size_t>(std::distance(range.first, range.second)));
+    }
+
     void resize(std::size_t newSize)
     {
         GASSERT(newSize <= capacity());
@@ -630,14 +668,16 @@ protected:
         GASSERT(empty());
 
         auto rangeOne = other.arrayOne();
-        for (auto iter = rangeOne.first; iter != rangeOne.second; ++iter) {
-            pushBackNotFull(std::forward<ElemRefType>(*iter));
-        }
+        pushBackElements<ElemRefType>(
+            rangeOne.first,
+            static_cast<std::size_t>(std::distance(rangeOne.first, rangeOne.second)),
+            CopyTag());
 
         auto rangeTwo = other.arrayTwo();
-        for (auto iter = rangeTwo.first; iter != rangeTwo.second; ++iter) {
-            pushBackNotFull(std::forward<ElemRefType>(*iter));
-        }
+        pushBackElements<ElemRefType>(
+            rangeTwo.first,
+            static_cast<std::size_t>(std::distance(rangeTwo.first, rangeTwo.second)),
+            CopyTag());
     }
 
     template <typename U>
@@ -650,6 +690,15 @@ protected:
         pushBackNotFull(std::forward<U>(value));
     }
 
+    void pushBack(ConstPointer values, std::size_t count)
+    {
+        GASSERT(count <= (capacity() - size()));
+        pushBackElements<ConstReference>(
+            values,
+            std::min(count, capacity() - size()),
+            CopyTag());
+    }
+
     template <typename... TArgs>
     void emplaceBack(TArgs&&... args)
     {
@@ -707,7 +756,7 @@ protected:
         currIter = firstCompEnd;
         otherCurrIter += firstCompSize;
 
-        if (currIter != rangeOne.first) {
+        if (currIter != rangeOne.second) {
             otherCurrIter = otherRangeTwo.first;
             if (!std::equal(currIter, rangeOne.second, otherCurrIter)) {
                 return false;
@@ -722,7 +771,7 @@ protected:
             }
 
             currIter += otherRangeOne.second - otherCurrIter;
-            otherCurrIter = otherRangeOne.first;
+            otherCurrIter = otherRangeTwo.first;
         }
 
         GASSERT(std::distance(currIter, rangeTwo.second) == std::distance(otherCurrIter, otherRangeTwo.second));
@@ -735,6 +784,147 @@ protected:
     }
 
 private:
+    struct ElementwiseTag {};
+    struct BulkTag {};
+    struct CompareWrapTag {};
+    struct MaskWrapTag {};
+
+    typedef typename std::conditional<
+        std::is_trivially_copyable<ValueType>::value,
+        BulkTag,
+        ElementwiseTag
+    >::type CopyTag;
+
+    typedef typename std::conditional<
+        std::is_trivially_destructible<ValueType>::value,
+        BulkTag,
+        ElementwiseTag
+    >::type DestructTag;
+
+    typedef typename std::conditional<
+        TPowerOfTwo,
+        MaskWrapTag,
+        CompareWrapTag
+    >::type WrapTag;
+
+    template <typename TElemRef, typename TPtr>
+    void pushBackElements(TPtr values, std::size_t count, ElementwiseTag)
+    {
+        for (auto idx = 0U; idx < count; ++idx) {
+            pushBackNotFull(std::forward<TElemRef>(values[idx]));
+        }
+    }
+
+    template <typename TElemRef, typename TPtr>
+    void pushBackElements(TPtr values, std::size_t count, BulkTag)
+    {
+        GASSERT(count <= (capacity() - size()));
+        if (count == 0) {
+            return;
+        }
+
+        rehomeIfEmpty();
+        auto writeIdx = rawIndex(size());
+        auto firstCount = std::min(count, capacity() - writeIdx);
+        std::memcpy(&data_[writeIdx], &values[0], firstCount * sizeof(ValueType));
+        if (firstCount < count) {
+            std::memcpy(&data_[0], &values[firstCount], (count - firstCount) * sizeof(ValueType));
+        }
+        count_ += count;
+    }
+
+    void copyFrontElements(Pointer values, std::size_t count, ElementwiseTag)
+    {
+        for (auto idx = 0U; idx < count; ++idx) {
+            values[idx] = std::move(elementAtIndex(idx));
+        }
+    }
+
+    void copyFrontElements(Pointer values, std::size_t count, BulkTag)
+    {
+        GASSERT(count <= size());
+        if (count == 0) {
+            return;
+        }
+
+        auto firstCount = std::min(count, capacity() - startIdx_);
+        std::memcpy(values, &data_[startIdx_], firstCount * sizeof(ValueType));
+        if (firstCount < count) {
+            std::memcpy(values + firstCount, &data_[0], (count - firstCount) * sizeof(ValueType));
+        }
+    }
+
+    void popFrontElements(std::size_t count, ElementwiseTag)
+    {
+        while (0 < count) {
+            popFront();
+            --count;
+        }
+    }
+
+    void popFrontElements(std::size_t count, BulkTag)
+    {
+        GASSERT(count <= size());
+        count_ -= count;
+        startIdx_ = rawIndex(count);
+    }
+
+    void popBackElements(std::size_t count, ElementwiseTag)
+    {
+        while (0 < count) {
+            popBack();
+            --count;
+        }
+    }
+
+    void popBackElements(std::size_t count, BulkTag)
+    {
+        GASSERT(count <= size());
+        count_ -= count;
+    }
+
+    void rehomeIfEmpty()
+    {
+        // Popping elements never moves the start of an empty queue, so
+        // the area returned by reserveContiguous() stays valid when the
+        // queue is drained before commit(). The start is moved back to
+        // the beginning of the storage only when new elements are
+        // appended.
+        if (empty()) {
+            startIdx_ = 0;
+        }
+    }
+
+    std::size_t contiguousSpace() const
+    {
+        if (full()) {
+            return 0;
+        }
+
+        auto writeIdx = rawIndex(size());
+        if ((!empty()) && (writeIdx < startIdx_)) {
+            return startIdx_ - writeIdx;
+        }
+        return capacity() - writeIdx;
+    }
+
+    std::size_t rawIndex(std::size_t index) const
+    {
+        return wrapIndex(startIdx_ + index, WrapTag());
+    }
+
+    std::size_t wrapIndex(std::size_t rawIdx, CompareWrapTag) const
+    {
+        while (capacity() <= rawIdx) {
+            rawIdx -= capacity();
+        }
+        return rawIdx;
+    }
+
+    std::size_t wrapIndex(std::size_t rawIdx, MaskWrapTag) const
+    {
+        return rawIdx & (capacity() - 1);
+    }
 
     template <typename U>
     void createValueAtIndex(U&& value, std::size_t index)
@@ -749,6 +939,7 @@ private:
     void pushBackNotFull(U&& value)
     {
         GASSERT(!full());
+        rehomeIfEmpty();
         createValueAtIndex(std::forward<U>(value), size());
         ++count_;
     }
@@ -757,6 +948,7 @@ private:
     void emplaceBackNotFull(TArgs&&... args)
     {
         GASSERT(!full());
+        rehomeIfEmpty();
         Reference elementRef = elementAtIndex(size());
         auto elementPtr = new(&elementRef) ValueType(std::forward<TArgs>(args)...);
         static_cast<void>(elementPtr);
@@ -768,13 +960,7 @@ private:
     {
         GASSERT(!full());
         createValueAtIndex(std::forward<U>(value), capacity() - 1);
-        if (startIdx_ == 0) {
-            startIdx_ = capacity() - 1;
-        }
-        else {
-            --startIdx_;
-        }
-
+        startIdx_ = rawIndex(capacity() - 1);
         ++count_;
     }
 
@@ -829,12 +1015,7 @@ private:
 
     ConstReference elementAtIndex(std::size_t index) const
     {
-        std::size_t rawIdx = startIdx_ + index;
-        while (capacity() <= rawIdx) {
-            rawIdx = rawIdx - capacity();
-        }
-
-        auto cellAddr = &data_[rawIdx];
+        auto cellAddr = &data_[rawIndex(index)];
         return *(reinterpret_cast<ConstPointer>(cellAddr));
     }
 
@@ -977,11 +1158,11 @@ private:
     std::size_t count_;
 };
 
-template <typename T>
+template <typename T, bool TPowerOfTwo>
 template <typename TDerived, typename TQueueType>
-class StaticQueueBase<T>::IteratorBase
+class StaticQueueBase<T, TPowerOfTwo>::IteratorBase
 {
-    friend class StaticQueueBase<T>;
+    friend class StaticQueueBase<T, TPowerOfTwo>;
 public:
 
     IteratorBase(const IteratorBase&) = default;
@@ -1159,13 +1340,13 @@ private:
     ArrayIterator iterator_; ///< Low level array iterator
 };
 
-template <typename T>
-class StaticQueueBase<T>::ConstIterator :
-            public StaticQueueBase<T>::template
-                IteratorBase<typename StaticQueueBase<T>::ConstIterator, const StaticQueueBase<T> >
+template <typename T, bool TPowerOfTwo>
+class StaticQueueBase<T, TPowerOfTwo>::ConstIterator :
+            public StaticQueueBase<T, TPowerOfTwo>::template
+                IteratorBase<typename StaticQueueBase<T, TPowerOfTwo>::ConstIterator, const StaticQueueBase<T, TPowerOfTwo> >
 {
-    typedef typename StaticQueueBase<T>::template
-        IteratorBase<typename StaticQueueBase<T>::ConstIterator, const StaticQueueBase<T> > Base;
+    typedef typename StaticQueueBase<T, TPowerOfTwo>::template
+        IteratorBase<typename StaticQueueBase<T, TPowerOfTwo>::ConstIterator, const StaticQueueBase<T, TPowerOfTwo> > Base;
 
 public:
     typedef typename Base::QueueType QueueType;
@@ -1181,13 +1362,13 @@ public:
 
 };
 
-template <typename T>
-class StaticQueueBase<T>::Iterator :
-            public StaticQueueBase<T>::template
-                IteratorBase<typename StaticQueueBase<T>::Iterator, StaticQueueBase<T> >
+template <typename T, bool TPowerOfTwo>
+class StaticQueueBase<T, TPowerOfTwo>::Iterator :
+            public StaticQueueBase<T, TPowerOfTwo>::template
+                IteratorBase<typename StaticQueueBase<T, TPowerOfTwo>::Iterator, StaticQueueBase<T, TPowerOfTwo> >
 {
-    typedef typename StaticQueueBase<T>::template
-        IteratorBase<typename StaticQueueBase<T>::Iterator, StaticQueueBase<T> > Base;
+    typedef typename StaticQueueBase<T, TPowerOfTwo>::template
+        IteratorBase<typename StaticQueueBase<T, TPowerOfTwo>::Iterator, StaticQueueBase<T, TPowerOfTwo> > Base;
 
 public:
     typedef typename Base::QueueType QueueType;
@@ -1208,10 +1389,10 @@ public:
 };
 
 
-template <typename TWrapperElemType, typename TQueueElemType>
-class CastWrapperQueueBase : public StaticQueueBase<TQueueElemType>
+template <typename TWrapperElemType, typename TQueueElemType, bool TPowerOfTwo>
+class CastWrapperQueueBase : public StaticQueueBase<TQueueElemType, TPowerOfTwo>
 {
-    typedef StaticQueueBase<TQueueElemType> Base;
+    typedef StaticQueueBase<TQueueElemType, TPowerOfTwo> Base;
     typedef TWrapperElemType WrapperElemType;
 
     typedef typename Base::ValueType BaseValueType;
@@ -1226,6 +1407,8 @@ class CastWrapperQueueBase : public StaticQueueBase<TQueueElemType>
     typedef typename Base::ConstReverseLinearisedIterator BaseConstReverseLinearisedIterator;
     typedef typename Base::LinearisedIteratorRange BaseLinearisedIteratorRange;
     typedef typename Base::ConstLinearisedIteratorRange BaseConstLinearisedIteratorRange;
+    typedef typename Base::ContiguousRegion BaseContiguousRegion;
+    typedef typename Base::ConstContiguousRegion BaseConstContiguousRegion;
 
 public:
 
@@ -1250,6 +1433,8 @@ protected:
     typedef std::reverse_iterator<ConstLinearisedIterator> ConstReverseLinearisedIterator;
     typedef std::pair<LinearisedIterator, LinearisedIterator> LinearisedIteratorRange;
     typedef std::pair<ConstLinearisedIterator, ConstLinearisedIterator> ConstLinearisedIteratorRange;
+    typedef std::pair<Pointer, std::size_t> ContiguousRegion;
+    typedef std::pair<ConstPointer, std::size_t> ConstContiguousRegion;
 
     CastWrapperQueueBase(StorageTypePtr data, std::size_t cap)
         : Base(reinterpret_cast<BaseStorageTypePtr>(data), cap)
@@ -1439,6 +1624,30 @@ protected:
 
     }
 
+    ContiguousRegion reserveContiguous(std::size_t maxCount)
+    {
+        auto region = Base::reserveContiguous(maxCount);
+        return ContiguousRegion(
+            reinterpret_cast<Pointer>(region.first),
+            region.second);
+    }
+
+    ContiguousRegion peekContiguous()
+    {
+        auto region = Base::peekContiguous();
+        return ContiguousRegion(
+            reinterpret_cast<Pointer>(region.first),
+            region.second);
+    }
+
+    ConstContiguousRegion peekContiguous() const
+    {
+        auto region = Base::peekContiguous();
+        return ConstContiguousRegion(
+            reinterpret_cast<ConstPointer>(region.first),
+            region.second);
+    }
+
     LinearisedIterator erase(LinearisedIterator pos)
     {
         return reinterpret_cast<LinearisedIterator>(
@@ -1494,6 +1703,21 @@ protected:
         Base::pushBack(reinterpret_cast<BaseConstReference>(value));
     }
 
+    void pushBack(ConstPointer values, std::size_t count)
+    {
+        Base::pushBack(reinterpret_cast<BaseConstPointer>(values), count);
+    }
+
+    void popFront(Pointer values, std::size_t count)
+    {
+        Base::popFront(reinterpret_cast<BasePointer>(values), count);
+    }
+
+    void popFront(std::size_t count)
+    {
+        Base::popFront(count);
+    }
+
     void pushFront(ConstReference value)
     {
         Base::pushFront(reinterpret_cast<BaseConstReference>(value));
@@ -1518,19 +1742,19 @@ protected:
     }
 };
 
-template <typename TWrapperElemType, typename TQueueElemType>
-class CastWrapperQueueBase<TWrapperElemType, TQueueElemType>::ConstIterator :
-                            public StaticQueueBase<TQueueElemType>::ConstIterator
+template <typename TWrapperElemType, typename TQueueElemType, bool TPowerOfTwo>
+class CastWrapperQueueBase<TWrapperElemType, TQueueElemType, TPowerOfTwo>::ConstIterator :
+                            public StaticQueueBase<TQueueElemType, TPowerOfTwo>::ConstIterator
 {
-    typedef typename StaticQueueBase<TQueueElemType>::ConstIterator Base;
+    typedef typename StaticQueueBase<TQueueElemType, TPowerOfTwo>::ConstIterator Base;
 public:
     ConstIterator(const ConstIterator&) = default;
     ConstIterator& operator=(const ConstIterator&) = default;
     ~ConstIterator() = default;
 
 protected:
-    typedef const StaticQueueBase<TWrapperElemType> ExpectedQueueType;
-    typedef const StaticQueueBase<TQueueElemType> ActualQueueType;
+    typedef const StaticQueueBase<TWrapperElemType, TPowerOfTwo> ExpectedQueueType;
+    typedef const StaticQueueBase<TQueueElemType, TPowerOfTwo> ActualQueueType;
     typedef TWrapperElemType ValueType;
     typedef const ValueType& Reference;
     typedef const ValueType& ConstReference;
@@ -1621,19 +1845,19 @@ protected:
     }
 };
 
-template <typename TWrapperElemType, typename TQueueElemType>
-class CastWrapperQueueBase<TWrapperElemType, TQueueElemType>::Iterator :
-                            public StaticQueueBase<TQueueElemType>::Iterator
+template <typename TWrapperElemType, typename TQueueElemType, bool TPowerOfTwo>
+class CastWrapperQueueBase<TWrapperElemType, TQueueElemType, TPowerOfTwo>::Iterator :
+                            public StaticQueueBase<TQueueElemType, TPowerOfTwo>::Iterator
 {
-    typedef typename StaticQueueBase<TQueueElemType>::Iterator Base;
+    typedef typename StaticQueueBase<TQueueElemType, TPowerOfTwo>::Iterator Base;
 public:
     Iterator(const Iterator&) = default;
     Iterator& operator=(const Iterator&) = default;
     ~Iterator() = default;
 
 protected:
-    typedef const StaticQueueBase<TWrapperElemType> ExpectedQueueType;
-    typedef const StaticQueueBase<TQueueElemType> ActualQueueType;
+    typedef const StaticQueueBase<TWrapperElemType, TPowerOfTwo> ExpectedQueueType;
+    typedef const StaticQueueBase<TQueueElemType, TPowerOfTwo> ActualQueueType;
     typedef TWrapperElemType ValueType;
     typedef ValueType& Reference;
     typedef const ValueType& ConstReference;
@@ -1724,10 +1948,10 @@ protected:
     }
 };
 
-template <typename T>
-class StaticQueueBaseOptimised : public StaticQueueBase<T>
+template <typename T, bool TPowerOfTwo>
+class StaticQueueBaseOptimised : public StaticQueueBase<T, TPowerOfTwo>
 {
-    typedef StaticQueueBase<T> Base;
+    typedef StaticQueueBase<T, TPowerOfTwo> Base;
 protected:
 
     typedef typename Base::StorageTypePtr StorageTypePtr;
@@ -1743,10 +1967,10 @@ protected:
     StaticQueueBaseOptimised& operator=(StaticQueueBaseOptimised&& other) = default;
 };
 
-template <>
-class StaticQueueBaseOptimised<std::int8_t> : public CastWrapperQueueBase<std::int8_t, std::uint8_t>
+template <bool TPowerOfTwo>
+class StaticQueueBaseOptimised<std::int8_t, TPowerOfTwo> : public CastWrapperQueueBase<std::int8_t, std::uint8_t, TPowerOfTwo>
 {
-    typedef CastWrapperQueueBase<std::int8_t, std::uint8_t> Base;
+    typedef CastWrapperQueueBase<std::int8_t, std::uint8_t, TPowerOfTwo> Base;
 protected:
 
     typedef typename Base::StorageTypePtr StorageTypePtr;
@@ -1761,10 +1985,10 @@ protected:
     StaticQueueBaseOptimised& operator=(StaticQueueBaseOptimised&& other) = default;
 };
 
-template <>
-class StaticQueueBaseOptimised<std::int16_t> : public CastWrapperQueueBase<std::int16_t, std::uint16_t>
+template <bool TPowerOfTwo>
+class StaticQueueBaseOptimised<std::int16_t, TPowerOfTwo> : public CastWrapperQueueBase<std::int16_t, std::uint16_t, TPowerOfTwo>
 {
-    typedef CastWrapperQueueBase<std::int16_t, std::uint16_t> Base;
+    typedef CastWrapperQueueBase<std::int16_t, std::uint16_t, TPowerOfTwo> Base;
 protected:
 
     typedef typename Base::StorageTypePtr StorageTypePtr;
@@ -1779,10 +2003,10 @@ protected:
     StaticQueueBaseOptimised& operator=(StaticQueueBaseOptimised&& other) = default;
 };
 
-template <>
-class StaticQueueBaseOptimised<std::int32_t> : public CastWrapperQueueBase<std::int32_t, std::uint32_t>
+template <bool TPowerOfTwo>
+class StaticQueueBaseOptimised<std::int32_t, TPowerOfTwo> : public CastWrapperQueueBase<std::int32_t, std::uint32_t, TPowerOfTwo>
 {
-    typedef CastWrapperQueueBase<std::int32_t, std::uint32_t> Base;
+    typedef CastWrapperQueueBase<std::int32_t, std::uint32_t, TPowerOfTwo> Base;
 protected:
 
     typedef typename Base::StorageTypePtr StorageTypePtr;
@@ -1797,10 +2021,10 @@ protected:
     StaticQueueBaseOptimised& operator=(StaticQueueBaseOptimised&& other) = default;
 };
 
-template <>
-class StaticQueueBaseOptimised<std::int64_t> : public CastWrapperQueueBase<std::int64_t, std::uint64_t>
+template <bool TPowerOfTwo>
+class StaticQueueBaseOptimised<std::int64_t, TPowerOfTwo> : public CastWrapperQueueBase<std::int64_t, std::uint64_t, TPowerOfTwo>
 {
-    typedef CastWrapperQueueBase<std::int64_t, std::uint64_t> Base;
+    typedef CastWrapperQueueBase<std::int64_t, std::uint64_t, TPowerOfTwo> Base;
 protected:
 
     typedef typename Base::StorageTypePtr StorageTypePtr;
@@ -1815,10 +2039,10 @@ protected:
     StaticQueueBaseOptimised& operator=(StaticQueueBaseOptimised&& other) = default;
 };
 
-template <typename T>
-class StaticQueueBaseOptimised<T*> : public CastWrapperQueueBase<T*, typename embxx::util::SizeToType<sizeof(T*)>::Type>
+template <typename T, bool TPowerOfTwo>
+class StaticQueueBaseOptimised<T*, TPowerOfTwo> : public CastWrapperQueueBase<T*, typename embxx::util::SizeToType<sizeof(T*)>::Type, TPowerOfTwo>
 {
-    typedef CastWrapperQueueBase<T*, typename embxx::util::SizeToType<sizeof(T*)>::Type> Base;
+    typedef CastWrapperQueueBase<T*, typename embxx::util::SizeToType<sizeof(T*)>::Type, TPowerOfTwo> Base;
 protected:
 
     typedef typename Base::StorageTypePtr StorageTypePtr;
@@ -1852,9 +2076,9 @@ protected:
 ///         elements.
 /// @headerfile embxx/container/StaticQueue.h
 template <typename T, std::size_t TSize>
-class StaticQueue : public details::StaticQueueBaseOptimised<T>
+class StaticQueue : public details::StaticQueueBaseOptimised<T, details::StaticQueueIsPowerOfTwo<TSize>::value>
 {
-    typedef details::StaticQueueBaseOptimised<T> Base;
+    typedef details::StaticQueueBaseOptimised<T, details::StaticQueueIsPowerOfTwo<TSize>::value> Base;
 
     typedef typename Base::StorageType StorageType;
 public:
@@ -1912,6 +2136,13 @@ public:
     /// @brief Const version of IteratorRange
     typedef typename Base::ConstLinearisedIteratorRange ConstLinearisedIteratorRange;
 
+    /// @brief Contiguous region type - std::pair of pointer to the first
+    ///        element and number of elements.
+    typedef typename Base::ContiguousRegion ContiguousRegion;
+
+    /// @brief Const version of ContiguousRegion
+    typedef typename Base::ConstContiguousRegion ConstContiguousRegion;
+
     /// @brief Const iterator class
     class ConstIterator;
 
@@ -1975,7 +2206,7 @@ public:
     StaticQueue(const StaticQueue<T, TAnySize>& queue)
         : Base(&array_[0], TSize)
     {
-        Base::assignElements(queue);
+        assignQueue(queue);
     }
 
     /// @brief Pseudo move constructor
@@ -1990,7 +2221,7 @@ public:
     StaticQueue(StaticQueue<T, TAnySize>&& queue)
         : Base(&array_[0], TSize)
     {
-        Base::assignElements(std::move(queue));
+        assignQueue(std::move(queue));
     }
 
     /// @brief Destructor
@@ -2049,7 +2280,9 @@ public:
     template <std::size_t TAnySize>
     StaticQueue& operator=(const StaticQueue<T, TAnySize>& queue)
     {
-        return static_cast<StaticQueue&>(Base::operator=(queue));
+        Base::clear();
+        assignQueue(queue);
+        return *this;
     }
 
     /// @brief Pseudo move assignment operator.
@@ -2066,7 +2299,9 @@ public:
     template <std::size_t TAnySize>
     StaticQueue& operator=(StaticQueue<T, TAnySize>&& queue)
     {
-        return static_cast<StaticQueue&>(Base::operator=(std::move(queue)));
+        Base::clear();
+        assignQueue(std::move(queue));
+        return *this;
     }
 
     /// @brief Returns capacity of the current queue
@@ -2206,6 +2441,22 @@ public:
         popFront(count);
     }
 
+    /// @brief Move number of the elements from the front of the queue
+    ///        into provided array and pop them.
+    /// @details For trivially copyable element types the elements are copied
+    ///          with at most two calls to std::memcpy(), otherwise they are
+    ///          move assigned one by one.
+    /// @param[out] values Pointer to the array of at least count elements.
+    /// @param[in] count number of elements to pop.
+    /// @pre @code count <= size() @endcode
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: No throw in case the move assignment and
+    ///       destructor of the elements don't throw. Basic guarantee otherwise.
+    void popFront(Pointer values, std::size_t count)
+    {
+        Base::popFront(values, count);
+    }
+
     /// @brief Add new element to the end of the queue.
     /// @details Uses copy/move constructor to copy/move the provided element.
     /// @param[in] value Value to insert
@@ -2219,6 +2470,21 @@ public:
         Base::pushBack(std::forward<U>(value));
     }
 
+    /// @brief Add number of elements to the end of the queue.
+    /// @details For trivially copyable element types the elements are copied
+    ///          with at most two calls to std::memcpy(), otherwise they are
+    ///          copy constructed one by one.
+    /// @param[in] values Pointer to the array of elements to add.
+    /// @param[in] count Number of the elements in the array.
+    /// @pre @code count <= (capacity() - size()) @endcode
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: No throw in case the copy constructor
+    ///       of the stored elements doesn't throw. Basic guarantee otherwise.
+    void pushBack(ConstPointer values, std::size_t count)
+    {
+        Base::pushBack(values, count);
+    }
+
     /// @brief Construct new element at the end of the queue.
     /// @details Passes all the provided arguments to the constructor of the
     ///          element.
@@ -2641,6 +2907,69 @@ public:
         return Base::arrayTwo();
     }
 
+    /// @brief Reserve contiguous area at the back of the queue to be
+    ///        written in place.
+    /// @details Returns the area that starts right after the last element
+    ///          and ends either at the end of the internal storage or at
+    ///          the front element, i.e. the area never wraps around.
+    ///          Fill the area (for example by DMA or read()-like
+    ///          function) and then call commit() to append the written
+    ///          elements to the queue. Available only for trivially
+    ///          copyable element types.
+    /// @param[in] maxCount Maximal number of elements to reserve.
+    /// @return Pointer to the first element of the area and number of
+    ///         elements in it. The number may be less than requested or
+    ///         0 if the queue is full.
+    /// @post The area remains valid when elements are popped from the
+    ///       front of the queue before commit(). Any other modification
+    ///       of the queue invalidates the reserved area.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: No throw.
+    ContiguousRegion reserveContiguous(std::size_t maxCount)
+    {
+        return Base::reserveContiguous(maxCount);
+    }
+
+    /// @brief Append elements written into area returned by
+    ///        reserveContiguous().
+    /// @param[in] count Number of written elements.
+    /// @pre count doesn't exceed the size of the reserved area.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: No throw.
+    void commit(std::size_t count)
+    {
+        Base::commit(count);
+    }
+
+    /// @brief Get contiguous area of elements at the front of the queue.
+    /// @details Same as arrayOne(), but returns the pointer to the front
+    ///          element and number of elements.
+    /// @note Thread safety: Safe for multiple readers, unsafe if there is
+    ///       a writer.
+    /// @note Exception guarantee: No throw.
+    ContiguousRegion peekContiguous()
+    {
+        return Base::peekContiguous();
+    }
+
+    /// @brief Const version of peekContiguous().
+    ConstContiguousRegion peekContiguous() const
+    {
+        return Base::peekContiguous();
+    }
+
+    /// @brief Pop elements processed in place after peekContiguous().
+    /// @details Same as popFront(std::size_t).
+    /// @param[in] count Number of elements to pop.
+    /// @pre @code count <= size() @endcode
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: No throw in case the destructor of the
+    ///       popped elements doesn't throw. Basic guarantee otherwise.
+    void consume(std::size_t count)
+    {
+        Base::popFront(count);
+    }
+
     /// @brief Resize the queue.
     /// @details In case the new size is greater than the existing one,
     ///          new elements are added to the back of the queue (default
@@ -2751,18 +3080,74 @@ public:
     template <std::size_t TAnySize>
     bool operator==(const StaticQueue<T, TAnySize>& other) const
     {
-        return Base::operator==(other);
+        return isEqual(other, SameBaseTag<TAnySize>());
     }
 
     /// @brief Non-equality comparison operator
     template <std::size_t TAnySize>
     bool operator!=(const StaticQueue<T, TAnySize>& other) const
     {
-        return Base::operator!=(other);
+        return !(*this == other);
     }
 
 
 private:
+    // Queues with power of two and other capacities have different bases
+    template <std::size_t TAnySize>
+    using SameBaseTag =
+        std::integral_constant<
+            bool,
+            details::StaticQueueIsPowerOfTwo<TSize>::value ==
+                details::StaticQueueIsPowerOfTwo<TAnySize>::value
+        >;
+
+    template <std::size_t TAnySize>
+    void assignQueue(const StaticQueue<T, TAnySize>& other)
+    {
+        assignQueueElements(other, SameBaseTag<TAnySize>());
+    }
+
+    template <std::size_t TAnySize>
+    void assignQueue(StaticQueue<T, TAnySize>&& other)
+    {
+        assignQueueElements(std::move(other), SameBaseTag<TAnySize>());
+    }
+
+    template <typename TOther>
+    void assignQueueElements(TOther&& other, std::true_type)
+    {
+        Base::assignElements(std::forward<TOther>(other));
+    }
+
+    template <typename TOther>
+    void assignQueueElements(TOther&& other, std::false_type)
+    {
+        typedef typename std::conditional<
+            std::is_rvalue_reference<TOther&&>::value,
+            ValueType&&,
+            const ValueType&
+        >::type ElemRefType;
+
+        GASSERT(other.size() <= capacity());
+        GASSERT(Base::empty());
+        for (auto& elem : other) {
+            Base::pushBack(std::forward<ElemRefType>(elem));
+        }
+    }
+
+    template <std::size_t TAnySize>
+    bool isEqual(const StaticQueue<T, TAnySize>& other, std::true_type) const
+    {
+        return Base::operator==(other);
+    }
+
+    template <std::size_t TAnySize>
+    bool isEqual(const StaticQueue<T, TAnySize>& other, std::false_type) const
+    {
+        return (size() == other.size()) &&
+               std::equal(begin(), end(), other.begin());
+    }
+
     typedef std::array<StorageType, TSize> ArrayType;
     ArrayType array_;
 };
@@ -963,12 +963,15 @@ struct DefaultCharacterTraits
 ///         // is used to perform reads, must have
 ///         // "void (const embxx::error::ErrorStatus&, std::size_t)" signature.
 ///         // If the driver is write-only one, this type may be std::nullptr_t.
+///         // The handler is invoked once per request, hence move-only
+///         // embxx::util::StaticUniqueFunction may be used.
 ///         typedef ... ReadHandler;
 ///
 ///         // The write complete callback handler storage type. In case the driver
 ///         // is used to perform write, must have
 ///         // "void (const embxx::error::ErrorStatus&, std::size_t)" signature.
 ///         // If the driver is read-only one, this type may be std::nullptr_t.
+///         // May be embxx::util::StaticUniqueFunction as well.
 ///         typedef ... WriteHandler;
 ///
 ///         // The "read-until" predicate storage type. In case the driver is
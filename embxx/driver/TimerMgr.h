@@ -101,7 +101,10 @@ namespace driver
 /// @tparam TTimeoutHandler The handler type provided with every wait request.
 ///         It must be either std::function<void (const embxx::error::ErrorStatus&)>
 ///         or embxx::util::StaticFunction<void (const embxx::error::ErrorStatus&), ...>
-///         if no dynamic memory allocation is allowed. Every provided handler
+///         if no dynamic memory allocation is allowed. The handler is
+///         invoked only once, hence move-only
+///         embxx::util::StaticUniqueFunction<void (const embxx::error::ErrorStatus&), ...>
+///         may be used as well. Every provided handler
 ///         function must have the following signature:
 ///         @code
 ///         void timeoutHandler(const embxx::error::ErrorStatus& err);
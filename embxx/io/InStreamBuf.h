@@ -372,41 +372,25 @@ void InStreamBuf<TDriver, TBufSize, TWaitHandler>::startAsyncRead()
     std::size_t nextReadSize =
         std::min(DefaultReadSize, buf_.capacity() - availableSize_);
 
-    buf_.resize(availableSize_ + nextReadSize);
-    auto rangeOne = buf_.arrayOne();
-    auto rangeOneDistance =
-        static_cast<std::size_t>(std::distance(rangeOne.first, rangeOne.second));
-
-    CharType* readPtr = nullptr;
-    if (availableSize_ < rangeOneDistance) {
-        readPtr = &(*(rangeOne.first + availableSize_));
-        nextReadSize = std::min(nextReadSize, rangeOneDistance - availableSize_);
-    }
-    else {
-        auto rangeTwo = buf_.arrayTwo();
-        auto rangeTwoDistance =
-            static_cast<std::size_t>(std::distance(rangeTwo.first, rangeTwo.second));
-
-        auto rangeTwoSize = availableSize_ - rangeOneDistance;
-        GASSERT(rangeTwoSize <= rangeTwoDistance);
-        readPtr = &(*(rangeTwo.first + rangeTwoSize));
-        nextReadSize = std::min(nextReadSize, rangeTwoDistance - rangeTwoSize);
-    }
-
     if (waitHandler_) {
         GASSERT(availableSize_ < waitAvailableDataSize_);
         nextReadSize = std::min(nextReadSize, waitAvailableDataSize_ - availableSize_);
     }
 
-    GASSERT(readPtr != nullptr);
+    // Data is read directly into the queue storage and appended on
+    // completion, consuming the data in the meantime doesn't invalidate
+    // the reserved area.
+    auto region = buf_.reserveContiguous(nextReadSize);
+    GASSERT(region.first != nullptr);
 
     readInProgress_ = true;
-    driver_.asyncRead(readPtr, nextReadSize,
+    driver_.asyncRead(region.first, region.second,
         [this](const embxx::error::ErrorStatus& es, std::size_t bytesRead)
         {
             readInProgress_ = false;
 
             GASSERT(availableSize_ + bytesRead <= buf_.capacity());
+            buf_.commit(bytesRead);
             availableSize_ += bytesRead;
 
             if (waitHandler_) {
@@ -54,7 +54,8 @@ namespace io
 ///         may contain.
 /// @tparam TWaitHandler Callback functor class to be called when requested
 ///         space becomes available. Must be either
-///         std::function or embxx::util::StaticFunction and have
+///         std::function, embxx::util::StaticFunction or move-only
+///         embxx::util::StaticUniqueFunction and have
 ///         "void (const embxx::error::ErrorStatus&)" signature. It is used to store
 ///         callback handler provided in asyncWaitAvailableCapacity() request.
 /// @pre No other components performs asynchronous write requests to the same
@@ -368,10 +369,7 @@ std::size_t OutStreamBuf<TDriver, TBufSize, TWaitHandler>::pushBack(
     const CharType* str, std::size_t strSize)
 {
     auto sizeToWrite = std::min(strSize, buf_.capacity() - buf_.size());
-    for (auto count = 0U; count < sizeToWrite; ++count) {
-        buf_.pushBack(*str);
-        ++str;
-    }
+    buf_.pushBack(str, sizeToWrite);
     return sizeToWrite;
 }
 
@@ -473,7 +471,9 @@ void OutStreamBuf<TDriver, TBufSize, TWaitHandler>::asyncWaitAvailableCapacity(
                 std::bind(std::forward<TFunc>(func), embxx::error::ErrorCode::Success));
         GASSERT((postResult) || (!"Failed to post handler, increase size of Event Loop"));
         static_cast<void>(postResult);
+        return;
     }
+
     waitAvailableCapacity_ = capacity;
     waitHandler_ = std::forward<TFunc>(func);
 }
@@ -56,8 +56,9 @@ namespace io
 ///         See embxx::driver::Character for reference.
 /// @tparam TSize Maximal size of the queue in terms of number of outstanding
 ///         write requests.
-/// @tparam THandler Handler class. Must be either std::function or
-///         embxx::util::StaticFunction and have
+/// @tparam THandler Handler class. Must be either std::function,
+///         embxx::util::StaticFunction or move-only
+///         embxx::util::StaticUniqueFunction and have
 ///         "void (const embxx::error::ErrorStatus&, std::size_t)" signature.
 /// @headerfile embxx/io/WriteQueue.h
 template <typename TDriver,
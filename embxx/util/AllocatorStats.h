@@ -0,0 +1,748 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/AllocatorStats.h
+/// This file contains definition of the allocators usage statistics and
+/// the allocator decorators that collect them.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+#include "embxx/util/Assert.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+/// @addtogroup util
+/// @{
+
+/// @brief Usage statistics of the allocator.
+/// @details Collects number of currently allocated (live) objects, peak
+///          number of live objects, number of failed allocations and
+///          distribution of the allocation sizes. The sizes are distributed
+///          among SizeBucketsCount buckets, the bucket with index N contains
+///          the allocations with sizes in range [2^N, 2^(N+1)), the last
+///          bucket contains all the bigger ones.
+///
+///          If TLiveRecordsCount is not 0, the address and size of every
+///          live allocation is recorded in the internal table, which may
+///          be reported by forEachLive() or dumpLive(), for example before
+///          shutdown to detect leaks. The records are placed into the
+///          table by the hash of the address (with linear probing), so
+///          the record of the released allocation is found in constant
+///          time on average. When the table is full, the following
+///          allocations are still counted, but not recorded.
+///
+///          The object is expected to be used by embxx::util::StatsAllocator
+///          or embxx::util::StatsStdAllocator. Use embxx::util::NoAllocatorStats
+///          instead to disable collection of the statistics.
+/// @tparam TLiveRecordsCount Maximal number of recorded live allocations.
+/// @note Thread safety: Unsafe
+/// @headerfile embxx/util/AllocatorStats.h
+template <std::size_t TLiveRecordsCount = 0>
+class AllocatorStats
+{
+public:
+    /// @brief Handle of the live allocation record.
+    typedef std::size_t RecordIdx;
+
+    /// @brief Handle returned when the allocation is not recorded.
+    static const RecordIdx NoRecord = TLiveRecordsCount;
+
+    /// @brief Number of buckets in sizes distribution.
+    static const std::size_t SizeBucketsCount = 16;
+
+    /// @brief Statistics are enabled.
+    static const bool Enabled = true;
+
+    /// @brief Constructor
+    AllocatorStats()
+        : currentCount_(0),
+          peakCount_(0),
+          totalCount_(0),
+          failedCount_(0),
+          currentBytes_(0),
+          peakBytes_(0),
+          recordsCount_(0)
+    {
+        sizeBuckets_.fill(0);
+        for (auto& record : records_) {
+            record.ptr_ = nullptr;
+            record.size_ = 0;
+        }
+    }
+
+    /// @brief Report successful allocation.
+    /// @param[in] ptr Address of the allocated space.
+    /// @param[in] size Size of the allocated space.
+    /// @return Handle of the live allocation record to be passed to
+    ///         released().
+    RecordIdx allocated(const void* ptr, std::size_t size)
+    {
+        ++currentCount_;
+        ++totalCount_;
+        currentBytes_ += size;
+        if (peakCount_ < currentCount_) {
+            peakCount_ = currentCount_;
+        }
+
+        if (peakBytes_ < currentBytes_) {
+            peakBytes_ = currentBytes_;
+        }
+
+        ++sizeBuckets_[sizeBucketIdx(size)];
+
+        if (recordsCount_ == TLiveRecordsCount) {
+            return NoRecord;
+        }
+
+        // Not full, i.e. there is at least one empty or removed record
+        auto idx = hashIdx(ptr);
+        while (isUsed(records_[idx])) {
+            idx = nextIdx(idx);
+        }
+
+        auto& record = records_[idx];
+        record.ptr_ = ptr;
+        record.size_ = size;
+        ++recordsCount_;
+        return idx;
+    }
+
+    /// @brief Report failed allocation.
+    /// @param[in] size Size of the requested space.
+    void failed(std::size_t size)
+    {
+        static_cast<void>(size);
+        ++failedCount_;
+    }
+
+    /// @brief Report release of the allocation.
+    /// @param[in] idx Handle returned by allocated().
+    /// @param[in] size Size of the allocated space.
+    void released(RecordIdx idx, std::size_t size)
+    {
+        GASSERT(0 < currentCount_);
+        GASSERT(size <= currentBytes_);
+        --currentCount_;
+        currentBytes_ -= size;
+        if (idx == NoRecord) {
+            return;
+        }
+
+        GASSERT(idx < TLiveRecordsCount);
+        GASSERT(isUsed(records_[idx]));
+        --recordsCount_;
+
+        // The record stays in the probing chain of the following ones,
+        // unless it is the last in the chain.
+        records_[idx].ptr_ = removedPtr();
+        while (records_[nextIdx(idx)].ptr_ == nullptr) {
+            records_[idx].ptr_ = nullptr;
+            idx = prevIdx(idx);
+            if (records_[idx].ptr_ != removedPtr()) {
+                break;
+            }
+        }
+    }
+
+    /// @brief Find the live allocation record by the address.
+    /// @details Used when the allocator doesn't keep the handle of
+    ///          the record. Probes the table starting from the hash of
+    ///          the address.
+    /// @return Handle of the record, NoRecord if not found.
+    RecordIdx findRecord(const void* ptr) const
+    {
+        if (recordsCount_ == 0) {
+            return NoRecord;
+        }
+
+        auto idx = hashIdx(ptr);
+        for (std::size_t count = 0; count < TLiveRecordsCount; ++count) {
+            auto& record = records_[idx];
+            if (record.ptr_ == ptr) {
+                return idx;
+            }
+
+            if (record.ptr_ == nullptr) {
+                break;
+            }
+            idx = nextIdx(idx);
+        }
+        return NoRecord;
+    }
+
+    /// @brief Number of currently allocated objects.
+    std::size_t currentCount() const
+    {
+        return currentCount_;
+    }
+
+    /// @brief Peak number of allocated objects.
+    std::size_t peakCount() const
+    {
+        return peakCount_;
+    }
+
+    /// @brief Total number of successful allocations.
+    std::size_t totalCount() const
+    {
+        return totalCount_;
+    }
+
+    /// @brief Number of failed allocations.
+    std::size_t failedCount() const
+    {
+        return failedCount_;
+    }
+
+    /// @brief Currently allocated bytes.
+    std::size_t currentBytes() const
+    {
+        return currentBytes_;
+    }
+
+    /// @brief Peak allocated bytes.
+    std::size_t peakBytes() const
+    {
+        return peakBytes_;
+    }
+
+    /// @brief Number of successful allocations in the size bucket.
+    /// @param[in] idx Index of the bucket, must be less than SizeBucketsCount.
+    std::size_t sizeBucket(std::size_t idx) const
+    {
+        GASSERT(idx < SizeBucketsCount);
+        return sizeBuckets_[idx];
+    }
+
+    /// @brief Get index of the size bucket for the allocation size.
+    static std::size_t sizeBucketIdx(std::size_t size)
+    {
+        std::size_t idx = 0;
+        while ((1 < size) && (idx < (SizeBucketsCount - 1))) {
+            size >>= 1;
+            ++idx;
+        }
+        return idx;
+    }
+
+    /// @brief Invoke provided functor for every recorded live allocation.
+    /// @param[in] func Functor with
+    ///            <b>void (const void* ptr, std::size_t size)</b> signature.
+    template <typename TFunc>
+    void forEachLive(TFunc&& func) const
+    {
+        for (auto& record : records_) {
+            if (isUsed(record)) {
+                func(record.ptr_, record.size_);
+            }
+        }
+    }
+
+    /// @brief Write the recorded live allocations into the output stream.
+    /// @param[in] stream Output stream, such as std::ostream.
+    template <typename TStream>
+    void dumpLive(TStream& stream) const
+    {
+        stream << "Live allocations: " << currentCount_ << " (" << currentBytes_ << " bytes)\n";
+        forEachLive(
+            [&stream](const void* ptr, std::size_t size)
+            {
+                stream << '\t' << ptr << ": " << size << " bytes\n";
+            });
+    }
+
+private:
+    struct Record
+    {
+        const void* ptr_;
+        std::size_t size_;
+    };
+
+    // Avoids division by zero when the recording is disabled
+    static const std::size_t TableSize =
+        (TLiveRecordsCount == 0U) ? 1U : TLiveRecordsCount;
+
+    // Marks the released record, that may be part of the probing chain
+    const void* removedPtr() const
+    {
+        return &records_;
+    }
+
+    bool isUsed(const Record& record) const
+    {
+        return (record.ptr_ != nullptr) && (record.ptr_ != removedPtr());
+    }
+
+    static std::size_t hashIdx(const void* ptr)
+    {
+        // Fibonacci hashing, the low bits of the address are mostly
+        // zeroes due to alignment.
+        auto value = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(ptr) >> 3);
+        return static_cast<std::size_t>(value * 2654435769U) % TableSize;
+    }
+
+    static std::size_t nextIdx(std::size_t idx)
+    {
+        return (idx + 1) % TableSize;
+    }
+
+    static std::size_t prevIdx(std::size_t idx)
+    {
+        return (idx + TableSize - 1) % TableSize;
+    }
+
+    std::size_t currentCount_;
+    std::size_t peakCount_;
+    std::size_t totalCount_;
+    std::size_t failedCount_;
+    std::size_t currentBytes_;
+    std::size_t peakBytes_;
+    std::array<std::size_t, SizeBucketsCount> sizeBuckets_;
+    std::array<Record, TLiveRecordsCount> records_;
+    std::size_t recordsCount_;
+};
+
+/// @brief Disabled allocator statistics.
+/// @details Has the same interface as embxx::util::AllocatorStats, but
+///          doesn't collect anything. When used with
+///          embxx::util::StatsAllocator or embxx::util::StatsStdAllocator,
+///          the decorated allocator is used directly, without any overhead.
+/// @headerfile embxx/util/AllocatorStats.h
+class NoAllocatorStats
+{
+public:
+    /// @brief Handle of the live allocation record.
+    typedef std::size_t RecordIdx;
+
+    /// @brief Handle returned when the allocation is not recorded.
+    static const RecordIdx NoRecord = 0;
+
+    /// @brief Number of buckets in sizes distribution.
+    static const std::size_t SizeBucketsCount = 0;
+
+    /// @brief Statistics are disabled.
+    static const bool Enabled = false;
+
+    /// @brief Always returns 0.
+    static constexpr std::size_t currentCount() { return 0; }
+
+    /// @brief Always returns 0.
+    static constexpr std::size_t peakCount() { return 0; }
+
+    /// @brief Always returns 0.
+    static constexpr std::size_t totalCount() { return 0; }
+
+    /// @brief Always returns 0.
+    static constexpr std::size_t failedCount() { return 0; }
+
+    /// @brief Always returns 0.
+    static constexpr std::size_t currentBytes() { return 0; }
+
+    /// @brief Always returns 0.
+    static constexpr std::size_t peakBytes() { return 0; }
+
+    /// @brief Always returns 0.
+    static constexpr std::size_t sizeBucket(std::size_t) { return 0; }
+
+    /// @brief Doesn't do anything.
+    template <typename TFunc>
+    static void forEachLive(TFunc&&) {}
+
+    /// @brief Doesn't do anything.
+    template <typename TStream>
+    static void dumpLive(TStream&) {}
+};
+
+/// @brief Decorator of the allocation policy, that collects the
+///        usage statistics.
+/// @details Wraps any allocator with the
+///          @code template <typename TObj, typename... TArgs> std::unique_ptr<TObj, Deleter> alloc(TArgs&&... args); @endcode
+///          interface, such as embxx::util::DynMemAllocator,
+///          embxx::util::InPlaceAllocator or
+///          embxx::util::SpecificInPlaceAllocator. The returned std::unique_ptr
+///          has the deleter that wraps the original one and reports the
+///          release of the object. It may be used as the allocator of
+///          embxx::comms::protocol::MsgIdLayer.
+/// @tparam TAllocator Decorated allocator.
+/// @tparam TStats Statistics type, either embxx::util::AllocatorStats or
+///         embxx::util::NoAllocatorStats. In the latter case this class
+///         is derived from TAllocator and its alloc() function is used
+///         directly.
+/// @note Thread safety: Unsafe
+/// @headerfile embxx/util/AllocatorStats.h
+template <typename TAllocator, typename TStats = AllocatorStats<> >
+class StatsAllocator
+{
+public:
+    /// @brief Type of the decorated allocator
+    typedef TAllocator Allocator;
+
+    /// @brief Type of the statistics
+    typedef TStats Stats;
+
+    /// @cond DOCUMENT_ASSERT_MANAGER
+
+    /// @brief Deleter class
+    /// @details Reports release of the object to the statistics and
+    ///          invokes the deleter of decorated allocator.
+    template <typename T, typename TDeleter>
+    class Deleter
+    {
+        template <typename U, typename UDeleter>
+        friend class Deleter;
+
+    public:
+        /// Constructor used by StatsAllocator to create std::unique_ptr
+        Deleter(
+            TDeleter&& deleter = TDeleter(),
+            Stats* stats = nullptr,
+            typename Stats::RecordIdx idx = Stats::NoRecord,
+            std::size_t size = 0)
+            : deleter_(std::move(deleter)),
+              stats_(stats),
+              idx_(idx),
+              size_(size)
+        {
+        }
+
+        /// Copy constructor is deleted
+        Deleter(const Deleter& other) = delete;
+
+        template <typename U, typename UDeleter>
+        Deleter(Deleter<U, UDeleter>&& other)
+            : deleter_(std::move(other.deleter_)),
+              stats_(other.stats_),
+              idx_(other.idx_),
+              size_(other.size_)
+        {
+            other.stats_ = nullptr;
+        }
+
+        /// Copy assignment is deleted
+        Deleter& operator=(const Deleter& other) = delete;
+
+        template <typename U, typename UDeleter>
+        Deleter& operator=(Deleter<U, UDeleter>&& other)
+        {
+            if (reinterpret_cast<void*>(this) == reinterpret_cast<const void*>(&other)) {
+                return *this;
+            }
+
+            deleter_ = std::move(other.deleter_);
+            stats_ = other.stats_;
+            idx_ = other.idx_;
+            size_ = other.size_;
+            other.stats_ = nullptr;
+            return *this;
+        }
+
+        /// @brief Deletion operator
+        void operator()(T* obj) {
+            GASSERT(stats_ != nullptr);
+            stats_->released(idx_, size_);
+            stats_ = nullptr;
+            deleter_(obj);
+        }
+
+    private:
+        TDeleter deleter_;
+        Stats* stats_;
+        typename Stats::RecordIdx idx_;
+        std::size_t size_;
+    };
+    /// @endcond
+
+    /// @brief Allocation function
+    /// @details Allocates the object using the decorated allocator and
+    ///          updates the statistics.
+    template <typename TObj, typename... TArgs>
+    std::unique_ptr<
+        TObj,
+        Deleter<TObj, typename decltype(std::declval<Allocator&>().template alloc<TObj>(std::declval<TArgs>()...))::deleter_type>
+    >
+    alloc(TArgs&&... args)
+    {
+        auto ptr = allocator_.template alloc<TObj>(std::forward<TArgs>(args)...);
+        typedef typename decltype(ptr)::deleter_type OrigDeleter;
+        typedef Deleter<TObj, OrigDeleter> Del;
+        std::unique_ptr<TObj, Del> result(nullptr, Del());
+        if (!ptr) {
+            stats_.failed(sizeof(TObj));
+            return std::move(result);
+        }
+
+        auto idx = stats_.allocated(ptr.get(), sizeof(TObj));
+        auto* obj = ptr.release();
+        result.get_deleter() = Del(std::move(ptr.get_deleter()), &stats_, idx, sizeof(TObj));
+        result.reset(obj);
+        return std::move(result);
+    }
+
+    /// @brief Same as alloc(), but returns raw pointer, the object must be
+    ///        released using deallocRaw().
+    template <typename TObj, typename... TArgs>
+    TObj* allocRaw(TArgs&&... args)
+    {
+        auto* obj = allocator_.template allocRaw<TObj>(std::forward<TArgs>(args)...);
+        if (obj == nullptr) {
+            stats_.failed(sizeof(TObj));
+            return nullptr;
+        }
+
+        stats_.allocated(obj, sizeof(TObj));
+        return obj;
+    }
+
+    /// @brief Report release of the object allocated by allocRaw() and
+    ///        release it using the decorated allocator.
+    template <typename TObj>
+    void deallocRaw(TObj* obj)
+    {
+        stats_.released(stats_.findRecord(obj), sizeof(TObj));
+        allocator_.deallocRaw(obj);
+    }
+
+    /// @brief Get statistics.
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+    /// @brief Get decorated allocator.
+    Allocator& getAllocator()
+    {
+        return allocator_;
+    }
+
+    /// @brief Const version of getAllocator()
+    const Allocator& getAllocator() const
+    {
+        return allocator_;
+    }
+
+private:
+    Allocator allocator_;
+    Stats stats_;
+};
+
+/// @cond DOCUMENT_NO_ALLOCATOR_STATS_SPECIALISATION
+template <typename TAllocator>
+class StatsAllocator<TAllocator, NoAllocatorStats> : public TAllocator
+{
+public:
+    typedef TAllocator Allocator;
+    typedef NoAllocatorStats Stats;
+
+    const Stats& stats() const
+    {
+        static const Stats NoStats;
+        return NoStats;
+    }
+
+    Allocator& getAllocator()
+    {
+        return *this;
+    }
+
+    const Allocator& getAllocator() const
+    {
+        return *this;
+    }
+};
+/// @endcond
+
+/// @brief Decorator of the std::allocator compatible allocator, that
+///        collects the usage statistics.
+/// @details Wraps the allocator, such as embxx::util::StaticPoolAllocator,
+///          and reports every allocation and deallocation to the statistics
+///          object provided in the constructor. The statistics object is
+///          shared with all the copies and rebound versions of the allocator,
+///          i.e. it reflects all the allocations of the container.
+/// @tparam TAllocator Decorated allocator.
+/// @tparam TStats Statistics type, either embxx::util::AllocatorStats or
+///         embxx::util::NoAllocatorStats. In the latter case this class
+///         is derived from TAllocator and its functions are used directly.
+/// @note Thread safety: Unsafe
+/// @headerfile embxx/util/AllocatorStats.h
+template <typename TAllocator, typename TStats = AllocatorStats<> >
+class StatsStdAllocator
+{
+    template <typename UAllocator, typename UStats>
+    friend class StatsStdAllocator;
+
+public:
+    typedef TAllocator Allocator;
+    typedef TStats Stats;
+    typedef typename Allocator::value_type value_type;
+    typedef typename Allocator::pointer pointer;
+    typedef typename Allocator::const_pointer const_pointer;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef StatsStdAllocator<
+            typename Allocator::template rebind<U>::other,
+            Stats> other;
+    };
+
+    /// @brief Constructor
+    /// @param[in] stats Statistics object, must outlive the allocator.
+    /// @param[in] allocator Decorated allocator.
+    explicit StatsStdAllocator(Stats& stats, const Allocator& allocator = Allocator())
+        : allocator_(allocator),
+          stats_(&stats)
+    {
+    }
+
+    template <typename U>
+    StatsStdAllocator(const StatsStdAllocator<U, Stats>& other)
+        : allocator_(other.allocator_),
+          stats_(other.stats_)
+    {
+    }
+
+    pointer allocate(size_type num)
+    {
+        auto* ptr = allocator_.allocate(num);
+        if (ptr == nullptr) {
+            stats_->failed(num * sizeof(value_type));
+            return ptr;
+        }
+
+        stats_->allocated(ptr, num * sizeof(value_type));
+        return ptr;
+    }
+
+    void deallocate(pointer ptr, size_type num)
+    {
+        stats_->released(stats_->findRecord(ptr), num * sizeof(value_type));
+        allocator_.deallocate(ptr, num);
+    }
+
+    size_type max_size() const
+    {
+        return allocator_.max_size();
+    }
+
+    /// @brief Get statistics.
+    const Stats& stats() const
+    {
+        return *stats_;
+    }
+
+    /// @brief Get decorated allocator.
+    const Allocator& getAllocator() const
+    {
+        return allocator_;
+    }
+
+private:
+    Allocator allocator_;
+    Stats* stats_;
+};
+
+/// @cond DOCUMENT_NO_ALLOCATOR_STATS_SPECIALISATION
+template <typename TAllocator>
+class StatsStdAllocator<TAllocator, NoAllocatorStats> : public TAllocator
+{
+public:
+    typedef TAllocator Allocator;
+    typedef NoAllocatorStats Stats;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef StatsStdAllocator<
+            typename Allocator::template rebind<U>::other,
+            Stats> other;
+    };
+
+    explicit StatsStdAllocator(Stats& stats, const Allocator& decorated = Allocator())
+        : Allocator(decorated)
+    {
+        static_cast<void>(stats);
+    }
+
+    template <typename U>
+    StatsStdAllocator(const StatsStdAllocator<U, Stats>& other)
+        : Allocator(other.getAllocator())
+    {
+    }
+
+    const Stats& stats() const
+    {
+        static const Stats NoStats;
+        return NoStats;
+    }
+
+    const Allocator& getAllocator() const
+    {
+        return *this;
+    }
+};
+/// @endcond
+
+/// @brief Equality comparison operator
+/// @related StatsStdAllocator
+template <typename TAllocator1, typename TAllocator2, typename TStats>
+bool operator==(
+    const StatsStdAllocator<TAllocator1, TStats>& alloc1,
+    const StatsStdAllocator<TAllocator2, TStats>& alloc2)
+{
+    return (&alloc1.stats() == &alloc2.stats()) &&
+           (alloc1.getAllocator() == alloc2.getAllocator());
+}
+
+/// @cond DOCUMENT_NO_ALLOCATOR_STATS_SPECIALISATION
+template <typename TAllocator1, typename TAllocator2>
+bool operator==(
+    const StatsStdAllocator<TAllocator1, NoAllocatorStats>& alloc1,
+    const StatsStdAllocator<TAllocator2, NoAllocatorStats>& alloc2)
+{
+    // No shared statistics object, equal when decorated allocators are.
+    return alloc1.getAllocator() == alloc2.getAllocator();
+}
+/// @endcond
+
+/// @brief Inequality comparison operator
+/// @related StatsStdAllocator
+template <typename TAllocator1, typename TAllocator2, typename TStats>
+bool operator!=(
+    const StatsStdAllocator<TAllocator1, TStats>& alloc1,
+    const StatsStdAllocator<TAllocator2, TStats>& alloc2)
+{
+    return !(alloc1 == alloc2);
+}
+
+/// @}
+
+}  // namespace util
+
+}  // namespace embxx
@@ -22,6 +22,9 @@
 
 #include <new>
 #include <cstddef>
+#include <cstdint>
+#include <array>
+#include <iterator>
 #include <memory>
 #include <type_traits>
 #include <tuple>
@@ -57,6 +60,25 @@ public:
     {
         return std::unique_ptr<TObj>(new TObj(std::forward<TArgs>(args)...));
     }
+
+    /// @brief Allocation function that returns raw pointer.
+    /// @details Same as alloc(), but the object is not managed by
+    ///          std::unique_ptr, it must be released using deallocRaw().
+    ///          Used by embxx::util::IntrusivePtrAllocator, which keeps
+    ///          only the pointer to the allocator inside the object.
+    template <typename TObj, typename... TArgs>
+    TObj* allocRaw(TArgs&&... args)
+    {
+        return new TObj(std::forward<TArgs>(args)...);
+    }
+
+    /// @brief Destruct the object allocated by allocRaw() and release
+    ///        its storage.
+    template <typename TObj>
+    void deallocRaw(TObj* obj)
+    {
+        delete obj;
+    }
 };
 
 /// @brief Object allocation policy that uses "in place" object construction.
@@ -193,6 +215,31 @@ public:
         return std::move(ptr);
     }
 
+    /// @brief Same as alloc(), but returns raw pointer, the object must be
+    ///        released using deallocRaw().
+    /// @return Pointer to constructed object, nullptr if allocation fails.
+    template <typename TObj, typename... TArgs>
+    TObj* allocRaw(TArgs&&... args)
+    {
+        if ((place_ == nullptr) || allocated_) {
+            return nullptr;
+        }
+
+        auto* obj = new (place_) TObj(std::forward<TArgs>(args)...);
+        allocated_ = true;
+        return obj;
+    }
+
+    /// @brief Destruct the object allocated by allocRaw().
+    template <typename TObj>
+    void deallocRaw(TObj* obj)
+    {
+        GASSERT(allocated_);
+        GASSERT(static_cast<void*>(obj) == place_);
+        obj->~TObj();
+        allocated_ = false;
+    }
+
 private:
     void* place_;
     bool allocated_;
@@ -243,6 +290,27 @@ public:
         return allocator_.alloc<TObj>(std::forward<TArgs>(args)...);
     }
 
+    /// @brief Same as alloc(), but returns raw pointer, the object must be
+    ///        released using deallocRaw().
+    template <typename TObj, typename... TArgs>
+    TObj* allocRaw(TArgs&&... args)
+    {
+        static_assert(sizeof(TObj) <= sizeof(place_),
+                                "Must be enough space for allocation");
+
+        static_assert(std::alignment_of<TObj>::value <= TAlignment,
+                                "Failed alignment requirements");
+
+        return allocator_.allocRaw<TObj>(std::forward<TArgs>(args)...);
+    }
+
+    /// @brief Destruct the object allocated by allocRaw().
+    template <typename TObj>
+    void deallocRaw(TObj* obj)
+    {
+        allocator_.deallocRaw(obj);
+    }
+
 private:
     typename std::aligned_storage<TSize, TAlignment>::type place_;
     BasicInPlaceAllocator allocator_;
@@ -280,13 +348,959 @@ public:
         static_assert(IsInTuple<TObj, TTuple>::Value,
                     "TObj must be included in TTuple");
 
-        return allocator_.alloc<TObj>(std::forward<TArgs>(args)...);
+        return allocator_.template alloc<TObj>(std::forward<TArgs>(args)...);
+    }
+
+    /// @brief Same as alloc(), but returns raw pointer, the object must be
+    ///        released using deallocRaw().
+    template <typename TObj, typename... TArgs>
+    TObj* allocRaw(TArgs&&... args)
+    {
+        static_assert(IsInTuple<TObj, TTuple>::Value,
+                    "TObj must be included in TTuple");
+
+        return allocator_.template allocRaw<TObj>(std::forward<TArgs>(args)...);
+    }
+
+    /// @brief Destruct the object allocated by allocRaw().
+    template <typename TObj>
+    void deallocRaw(TObj* obj)
+    {
+        allocator_.deallocRaw(obj);
+    }
+
+private:
+    Allocator allocator_;
+};
+
+/// @cond DOCUMENT_IN_PLACE_SLOTS_POOL
+namespace details
+{
+
+template <std::size_t TSlotsCount>
+struct InPlaceSlotsPoolIndex
+{
+    typedef typename std::conditional<
+        (TSlotsCount < 0xff),
+        std::uint8_t,
+        typename std::conditional<
+            (TSlotsCount < 0xffff),
+            std::uint16_t,
+            std::size_t
+        >::type
+    >::type Type;
+};
+
+template <std::size_t TSize,
+          std::size_t TSlotsCount,
+          std::size_t TAlignment>
+class InPlaceSlotsPool
+{
+    static_assert(0 < TSlotsCount, "Number of slots mustn't be 0");
+
+public:
+    typedef typename InPlaceSlotsPoolIndex<TSlotsCount>::Type IndexType;
+
+    static const IndexType InvalidIdx = static_cast<IndexType>(TSlotsCount);
+
+    InPlaceSlotsPool()
+        : freeHead_(0),
+          allocatedCount_(0)
+    {
+        for (std::size_t idx = 0; idx < TSlotsCount; ++idx) {
+            next_[idx] = static_cast<IndexType>(idx + 1);
+        }
+    }
+
+    InPlaceSlotsPool(const InPlaceSlotsPool&) = delete;
+
+    ~InPlaceSlotsPool()
+    {
+        GASSERT(allocatedCount_ == 0);
+    }
+
+    InPlaceSlotsPool& operator=(const InPlaceSlotsPool&) = delete;
+
+    // Returns the slot that will be taken by the next takeSlot() call,
+    // nullptr if all the slots are in use.
+    void* nextSlot()
+    {
+        if (freeHead_ == InvalidIdx) {
+            return nullptr;
+        }
+        return &slots_[freeHead_];
+    }
+
+    IndexType takeSlot()
+    {
+        GASSERT(freeHead_ != InvalidIdx);
+        auto idx = freeHead_;
+        freeHead_ = next_[idx];
+        ++allocatedCount_;
+        return idx;
+    }
+
+    void releaseSlot(IndexType idx)
+    {
+        GASSERT(idx < TSlotsCount);
+        GASSERT(0 < allocatedCount_);
+        next_[idx] = freeHead_;
+        freeHead_ = idx;
+        --allocatedCount_;
+    }
+
+    std::size_t allocatedCount() const
+    {
+        return allocatedCount_;
+    }
+
+    IndexType slotIdx(const void* slot) const
+    {
+        auto idx = std::distance(&slots_[0], static_cast<const SlotType*>(slot));
+        GASSERT((0 <= idx) && (static_cast<std::size_t>(idx) < TSlotsCount));
+        return static_cast<IndexType>(idx);
+    }
+
+private:
+    typedef typename std::aligned_storage<TSize, TAlignment>::type SlotType;
+
+    std::array<SlotType, TSlotsCount> slots_;
+    std::array<IndexType, TSlotsCount> next_;
+    IndexType freeHead_;
+    std::size_t allocatedCount_;
+};
+
+}  // namespace details
+/// @endcond
+
+/// @brief Object allocation policy that uses "in place" object construction
+///        in one of multiple slots.
+/// @details Similar to InPlaceAllocator, but allocates private space for
+///          TSlotsCount objects, so multiple objects may be allocated
+///          at the same time. The free slots are linked in the free list,
+///          both allocation and deallocation are O(1) operations.
+///          The newly created object is returned wrapped in std::unique_ptr
+///          with a deleter that calls the destructor of the object and
+///          returns the slot to the free list.
+/// @tparam TSize Required size of a single slot.
+/// @tparam TSlotsCount Number of slots.
+/// @tparam TAlignment Required alignment. By default the alignment will
+///         be the same as alignment of "double", usually 8 bytes.
+/// @pre All the objects must be released before the allocator is destructed.
+/// @headerfile embxx/util/Allocators.h
+template <std::size_t TSize,
+          std::size_t TSlotsCount,
+          std::size_t TAlignment = std::alignment_of<double>::value>
+class MultiSlotInPlaceAllocator
+{
+    typedef details::InPlaceSlotsPool<TSize, TSlotsCount, TAlignment> Pool;
+    typedef typename Pool::IndexType IndexType;
+
+public:
+
+    /// @cond DOCUMENT_ASSERT_MANAGER
+
+    /// @brief Deleter class
+    template <typename T>
+    class Deleter
+    {
+        template<typename U>
+        friend class Deleter;
+
+    public:
+        /// Constructor used by MultiSlotInPlaceAllocator to create std::unique_ptr
+        Deleter(Pool* pool = nullptr, IndexType idx = Pool::InvalidIdx)
+            : pool_(pool),
+              idx_(idx)
+        {
+        }
+
+        /// Copy constructor is deleted
+        Deleter(const Deleter& other) = delete;
+
+        template <typename U>
+        Deleter(Deleter<U>&& other)
+            : pool_(other.pool_),
+              idx_(other.idx_)
+        {
+            static_assert(std::is_base_of<T, U>::value ||
+                          std::is_base_of<U, T>::value ||
+                          std::is_convertible<U, T>::value ||
+                          std::is_convertible<T, U>::value ,
+                "To make Deleter convertible, their template parameters "
+                "must be convertible.");
+
+            other.pool_ = nullptr;
+            other.idx_ = Pool::InvalidIdx;
+        }
+
+        ~Deleter()
+        {
+            GASSERT(pool_ == nullptr);
+        }
+
+        /// Copy assignment is deleted
+        Deleter& operator=(const Deleter& other) = delete;
+
+        template <typename U>
+        Deleter& operator=(Deleter<U>&& other)
+        {
+            static_assert(std::is_base_of<T, U>::value ||
+                          std::is_base_of<U, T>::value ||
+                          std::is_convertible<U, T>::value ||
+                          std::is_convertible<T, U>::value ,
+                "To make Deleter convertible, their template parameters "
+                "must be convertible.");
+
+            if (reinterpret_cast<void*>(this) == reinterpret_cast<const void*>(&other)) {
+                return *this;
+            }
+
+            GASSERT(pool_ == nullptr);
+            pool_ = other.pool_;
+            idx_ = other.idx_;
+            other.pool_ = nullptr;
+            other.idx_ = Pool::InvalidIdx;
+            return *this;
+        }
+
+        /// @brief Deletion operator
+        /// @details Executes destructor of the deleted object and returns
+        ///          its slot to the allocator.
+        void operator()(T* obj) {
+            GASSERT(pool_ != nullptr);
+            obj->~T();
+            pool_->releaseSlot(idx_);
+            pool_ = nullptr;
+            idx_ = Pool::InvalidIdx;
+        }
+
+    private:
+        Pool* pool_;
+        IndexType idx_;
+    };
+    /// @endcond
+
+    /// @brief Allocation function
+    /// @details Uses in place object construction in the first free slot.
+    /// @tparam TObj Type of object to by constructed
+    /// @tparam TArgs Types of the parameters required to create an object.
+    /// @return std::unique_ptr to constructed object with custom deleter that
+    ///         calls the destructor of the object. Empty if all the slots
+    ///         are in use.
+    /// @pre sizeof(TObj) <= TSize
+    /// @pre std::alignment_of<TObj>::value <= TAlignment.
+    template <typename TObj, typename... TArgs>
+    std::unique_ptr<TObj, Deleter<TObj> > alloc(TArgs&&... args)
+    {
+        static_assert(sizeof(TObj) <= TSize,
+                                "Must be enough space for allocation");
+
+        static_assert(std::alignment_of<TObj>::value <= TAlignment,
+                                "Failed alignment requirements");
+
+        typedef Deleter<TObj> Del;
+        std::unique_ptr<TObj, Del> ptr(nullptr, Del());
+        auto* place = pool_.nextSlot();
+        if (place == nullptr) {
+            return std::move(ptr);
+        }
+
+        ptr.reset(new (place) TObj(std::forward<TArgs>(args)...));
+        ptr.get_deleter() = Del(&pool_, pool_.takeSlot());
+        return std::move(ptr);
+    }
+
+    /// @brief Same as alloc(), but returns raw pointer, the object must be
+    ///        released using deallocRaw().
+    /// @return Pointer to constructed object, nullptr if all the slots
+    ///         are in use.
+    template <typename TObj, typename... TArgs>
+    TObj* allocRaw(TArgs&&... args)
+    {
+        static_assert(sizeof(TObj) <= TSize,
+                                "Must be enough space for allocation");
+
+        static_assert(std::alignment_of<TObj>::value <= TAlignment,
+                                "Failed alignment requirements");
+
+        auto* place = pool_.nextSlot();
+        if (place == nullptr) {
+            return nullptr;
+        }
+
+        auto* obj = new (place) TObj(std::forward<TArgs>(args)...);
+        pool_.takeSlot();
+        return obj;
+    }
+
+    /// @brief Destruct the object allocated by allocRaw() and return its
+    ///        slot to the free list.
+    template <typename TObj>
+    void deallocRaw(TObj* obj)
+    {
+        auto idx = pool_.slotIdx(obj);
+        obj->~TObj();
+        pool_.releaseSlot(idx);
+    }
+
+    /// @brief Number of slots.
+    static constexpr std::size_t slotsCount()
+    {
+        return TSlotsCount;
+    }
+
+    /// @brief Number of currently allocated objects.
+    std::size_t allocatedCount() const
+    {
+        return pool_.allocatedCount();
+    }
+
+private:
+    Pool pool_;
+};
+
+/// @brief Multi slot version of SpecificInPlaceAllocator.
+/// @details Calculates the required size and alignment of a slot to be able
+///          to safely allocate any of the types in TTuple and uses
+///          MultiSlotInPlaceAllocator for the allocations.
+/// @tparam TTuple std::tuple<...> with all the types this allocator can
+///         allocate
+/// @tparam TSlotsCount Number of objects that may be allocated at the
+///         same time.
+/// @headerfile embxx/util/Allocators.h
+template <typename TTuple, std::size_t TSlotsCount>
+class SpecificMultiSlotInPlaceAllocator
+{
+    static_assert(IsTuple<TTuple>::Value, "TTuple must be std::tuple");
+    typedef typename TupleAsAlignedUnion<TTuple>::Type AlignedStorage;
+
+public:
+
+    /// Using MultiSlotInPlaceAllocator
+    typedef MultiSlotInPlaceAllocator<
+        sizeof(AlignedStorage),
+        TSlotsCount,
+        std::alignment_of<AlignedStorage>::value> Allocator;
+
+    /// @brief Allocation function
+    /// @details Uses in place object construction
+    /// @tparam TObj Type of object to by constructed
+    /// @tparam TArgs Types of the parameters required to create an object.
+    /// @return std::unique_ptr to constructed object with custom deleter that
+    ///         calls the destructor of the object.
+    /// @pre TObj was included in TTuple.
+    template <typename TObj, typename... TArgs>
+    auto alloc(TArgs&&... args) -> decltype(std::declval<Allocator&>().template alloc<TObj>(std::forward<TArgs>(args)...))
+    {
+        static_assert(IsInTuple<TObj, TTuple>::Value,
+                    "TObj must be included in TTuple");
+
+        return allocator_.template alloc<TObj>(std::forward<TArgs>(args)...);
+    }
+
+    /// @brief Same as alloc(), but returns raw pointer, the object must be
+    ///        released using deallocRaw().
+    template <typename TObj, typename... TArgs>
+    TObj* allocRaw(TArgs&&... args)
+    {
+        static_assert(IsInTuple<TObj, TTuple>::Value,
+                    "TObj must be included in TTuple");
+
+        return allocator_.template allocRaw<TObj>(std::forward<TArgs>(args)...);
+    }
+
+    /// @brief Destruct the object allocated by allocRaw().
+    template <typename TObj>
+    void deallocRaw(TObj* obj)
+    {
+        allocator_.deallocRaw(obj);
+    }
+
+    /// @brief Number of currently allocated objects.
+    std::size_t allocatedCount() const
+    {
+        return allocator_.allocatedCount();
     }
 
 private:
     Allocator allocator_;
 };
 
+/// @brief Definition of the size class for SizeClassInPlaceAllocator.
+/// @tparam TMaxSize Maximal size of the object that belongs to the class.
+/// @tparam TSlotsCount Number of objects of the class that may be allocated
+///         at the same time.
+/// @headerfile embxx/util/Allocators.h
+template <std::size_t TMaxSize, std::size_t TSlotsCount>
+struct SizeClass
+{
+    /// @brief Maximal size of the object.
+    static const std::size_t MaxSize = TMaxSize;
+
+    /// @brief Number of slots.
+    static const std::size_t SlotsCount = TSlotsCount;
+};
+
+/// @cond DOCUMENT_SIZE_CLASS_DETAILS
+namespace details
+{
+
+template <typename TSizeClasses, std::size_t TAlignment>
+struct SizeClassPools;
+
+template <typename... TClasses, std::size_t TAlignment>
+struct SizeClassPools<std::tuple<TClasses...>, TAlignment>
+{
+    typedef std::tuple<
+        InPlaceSlotsPool<TClasses::MaxSize, TClasses::SlotsCount, TAlignment>...
+    > Type;
+};
+
+template <std::size_t TObjSize,
+          typename TSizeClasses,
+          std::size_t TIdx = 0,
+          bool TEnd = (std::tuple_size<TSizeClasses>::value <= TIdx)>
+struct SizeClassIdx
+{
+    typedef typename std::tuple_element<TIdx, TSizeClasses>::type Class;
+    static const std::size_t Value =
+        (TObjSize <= Class::MaxSize) ?
+            TIdx :
+            SizeClassIdx<TObjSize, TSizeClasses, TIdx + 1>::Value;
+};
+
+template <std::size_t TObjSize, typename TSizeClasses, std::size_t TIdx>
+struct SizeClassIdx<TObjSize, TSizeClasses, TIdx, true>
+{
+    static const std::size_t Value = TIdx;
+};
+
+template <typename TSizeClasses,
+          std::size_t TIdx = 1,
+          bool TEnd = (std::tuple_size<TSizeClasses>::value <= TIdx)>
+struct AreSizeClassesSorted
+{
+    typedef typename std::tuple_element<TIdx - 1, TSizeClasses>::type First;
+    typedef typename std::tuple_element<TIdx, TSizeClasses>::type Second;
+    static const bool Value =
+        (First::MaxSize < Second::MaxSize) &&
+        AreSizeClassesSorted<TSizeClasses, TIdx + 1>::Value;
+};
+
+template <typename TSizeClasses, std::size_t TIdx>
+struct AreSizeClassesSorted<TSizeClasses, TIdx, true>
+{
+    static const bool Value = true;
+};
+
+template <std::size_t TCount>
+struct SizeClassPoolsAllocatedCount
+{
+    template <typename TPools>
+    static std::size_t count(const TPools& pools)
+    {
+        return std::get<TCount - 1>(pools).allocatedCount() +
+               SizeClassPoolsAllocatedCount<TCount - 1>::count(pools);
+    }
+};
+
+template <>
+struct SizeClassPoolsAllocatedCount<0>
+{
+    template <typename TPools>
+    static std::size_t count(const TPools& pools)
+    {
+        static_cast<void>(pools);
+        return 0;
+    }
+};
+
+}  // namespace details
+/// @endcond
+
+/// @brief Object allocation policy that uses "in place" object construction
+///        in the pools of different size classes.
+/// @details SpecificMultiSlotInPlaceAllocator reserves the size of the
+///          largest type for every slot. When the sizes of the allocated
+///          types differ a lot, most of the space is wasted. This allocator
+///          groups the types into size classes, every size class has its own
+///          pool of slots of the class size. The size class is selected
+///          statically, based on the size of the allocated type: it is the
+///          first class (the classes are sorted by size) that may contain
+///          the object. There is no fallback to bigger classes, the
+///          allocation fails if all the slots of the selected class are
+///          in use. Allocation and deallocation are O(1) operations.
+///
+///          The newly created object is returned wrapped in std::unique_ptr
+///          with a deleter that calls the destructor of the object and
+///          returns the slot to the pool of its class. The type of the
+///          deleter doesn't depend on the size class, so the pointer to
+///          any object may be converted to the pointer to its base class.
+/// @tparam TTuple std::tuple<...> with all the types this allocator can
+///         allocate
+/// @tparam TSizeClasses std::tuple<...> of embxx::util::SizeClass definitions,
+///         sorted in ascending order of the maximal size.
+/// @pre All the objects must be released before the allocator is destructed.
+/// @headerfile embxx/util/Allocators.h
+template <typename TTuple, typename TSizeClasses>
+class SizeClassInPlaceAllocator
+{
+    static_assert(IsTuple<TTuple>::Value, "TTuple must be std::tuple");
+    static_assert(IsTuple<TSizeClasses>::Value, "TSizeClasses must be std::tuple");
+    static_assert(0 < std::tuple_size<TSizeClasses>::value,
+        "There must be at least one size class");
+    static_assert(details::AreSizeClassesSorted<TSizeClasses>::Value,
+        "The size classes must be sorted in ascending order of their sizes");
+
+    static const std::size_t Alignment =
+        std::alignment_of<typename TupleAsAlignedUnion<TTuple>::Type>::value;
+
+    typedef typename details::SizeClassPools<TSizeClasses, Alignment>::Type Pools;
+
+    typedef void (*ReleaseFunc)(SizeClassInPlaceAllocator&, std::size_t);
+
+public:
+
+    /// @cond DOCUMENT_ASSERT_MANAGER
+
+    /// @brief Deleter class
+    template <typename T>
+    class Deleter
+    {
+        template<typename U>
+        friend class Deleter;
+
+    public:
+        /// Constructor used by SizeClassInPlaceAllocator to create std::unique_ptr
+        Deleter(
+            SizeClassInPlaceAllocator* allocator = nullptr,
+            ReleaseFunc releaseFunc = nullptr,
+            std::size_t idx = 0)
+            : allocator_(allocator),
+              releaseFunc_(releaseFunc),
+              idx_(idx)
+        {
+        }
+
+        /// Copy constructor is deleted
+        Deleter(const Deleter& other) = delete;
+
+        template <typename U>
+        Deleter(Deleter<U>&& other)
+            : allocator_(other.allocator_),
+              releaseFunc_(other.releaseFunc_),
+              idx_(other.idx_)
+        {
+            static_assert(std::is_base_of<T, U>::value ||
+                          std::is_base_of<U, T>::value ||
+                          std::is_convertible<U, T>::value ||
+                          std::is_convertible<T, U>::value ,
+                "To make Deleter convertible, their template parameters "
+                "must be convertible.");
+
+            other.allocator_ = nullptr;
+            other.releaseFunc_ = nullptr;
+        }
+
+        ~Deleter()
+        {
+            GASSERT(allocator_ == nullptr);
+        }
+
+        /// Copy assignment is deleted
+        Deleter& operator=(const Deleter& other) = delete;
+
+        template <typename U>
+        Deleter& operator=(Deleter<U>&& other)
+        {
+            static_assert(std::is_base_of<T, U>::value ||
+                          std::is_base_of<U, T>::value ||
+                          std::is_convertible<U, T>::value ||
+                          std::is_convertible<T, U>::value ,
+                "To make Deleter convertible, their template parameters "
+                "must be convertible.");
+
+            if (reinterpret_cast<void*>(this) == reinterpret_cast<const void*>(&other)) {
+                return *this;
+            }
+
+            GASSERT(allocator_ == nullptr);
+            allocator_ = other.allocator_;
+            releaseFunc_ = other.releaseFunc_;
+            idx_ = other.idx_;
+            other.allocator_ = nullptr;
+            other.releaseFunc_ = nullptr;
+            return *this;
+        }
+
+        /// @brief Deletion operator
+        /// @details Executes destructor of the deleted object and returns
+        ///          its slot to the pool of its size class.
+        void operator()(T* obj) {
+            GASSERT(allocator_ != nullptr);
+            GASSERT(releaseFunc_ != nullptr);
+            obj->~T();
+            releaseFunc_(*allocator_, idx_);
+            allocator_ = nullptr;
+            releaseFunc_ = nullptr;
+        }
+
+    private:
+        SizeClassInPlaceAllocator* allocator_;
+        ReleaseFunc releaseFunc_;
+        std::size_t idx_;
+    };
+    /// @endcond
+
+    /// @brief Default constructor
+    SizeClassInPlaceAllocator() = default;
+
+    /// Copy constructor is deleted
+    SizeClassInPlaceAllocator(const SizeClassInPlaceAllocator&) = delete;
+
+    /// Copy assignment is deleted
+    SizeClassInPlaceAllocator& operator=(const SizeClassInPlaceAllocator&) = delete;
+
+    /// @brief Allocation function
+    /// @details Uses in place object construction in the free slot of the
+    ///          size class selected at compile time.
+    /// @tparam TObj Type of object to by constructed
+    /// @tparam TArgs Types of the parameters required to create an object.
+    /// @return std::unique_ptr to constructed object with custom deleter that
+    ///         calls the destructor of the object. Empty if all the slots
+    ///         of the size class are in use.
+    /// @pre TObj was included in TTuple.
+    template <typename TObj, typename... TArgs>
+    std::unique_ptr<TObj, Deleter<TObj> > alloc(TArgs&&... args)
+    {
+        static_assert(IsInTuple<TObj, TTuple>::Value,
+                    "TObj must be included in TTuple");
+
+        static const std::size_t ClassIdx =
+            details::SizeClassIdx<sizeof(TObj), TSizeClasses>::Value;
+
+        static_assert(ClassIdx < std::tuple_size<TSizeClasses>::value,
+            "TObj doesn't fit any of the size classes");
+
+        typedef Deleter<TObj> Del;
+        std::unique_ptr<TObj, Del> ptr(nullptr, Del());
+        auto& pool = std::get<ClassIdx>(pools_);
+        auto* place = pool.nextSlot();
+        if (place == nullptr) {
+            return std::move(ptr);
+        }
+
+        ptr.reset(new (place) TObj(std::forward<TArgs>(args)...));
+        ptr.get_deleter() =
+            Del(this, &SizeClassInPlaceAllocator::template release<ClassIdx>, pool.takeSlot());
+        return std::move(ptr);
+    }
+
+    /// @brief Same as alloc(), but returns raw pointer, the object must be
+    ///        released using deallocRaw().
+    /// @return Pointer to constructed object, nullptr if all the slots
+    ///         of the size class are in use.
+    template <typename TObj, typename... TArgs>
+    TObj* allocRaw(TArgs&&... args)
+    {
+        static_assert(IsInTuple<TObj, TTuple>::Value,
+                    "TObj must be included in TTuple");
+
+        static const std::size_t ClassIdx =
+            details::SizeClassIdx<sizeof(TObj), TSizeClasses>::Value;
+
+        static_assert(ClassIdx < std::tuple_size<TSizeClasses>::value,
+            "TObj doesn't fit any of the size classes");
+
+        auto& pool = std::get<ClassIdx>(pools_);
+        auto* place = pool.nextSlot();
+        if (place == nullptr) {
+            return nullptr;
+        }
+
+        auto* obj = new (place) TObj(std::forward<TArgs>(args)...);
+        pool.takeSlot();
+        return obj;
+    }
+
+    /// @brief Destruct the object allocated by allocRaw() and return its
+    ///        slot to the pool of its size class.
+    template <typename TObj>
+    void deallocRaw(TObj* obj)
+    {
+        static const std::size_t ClassIdx =
+            details::SizeClassIdx<sizeof(TObj), TSizeClasses>::Value;
+
+        auto& pool = std::get<ClassIdx>(pools_);
+        auto idx = pool.slotIdx(obj);
+        obj->~TObj();
+        pool.releaseSlot(idx);
+    }
+
+    /// @brief Number of currently allocated objects in all the size classes.
+    std::size_t allocatedCount() const
+    {
+        return details::SizeClassPoolsAllocatedCount<
+            std::tuple_size<Pools>::value>::count(pools_);
+    }
+
+    /// @brief Number of currently allocated objects in the specified
+    ///        size class.
+    /// @tparam TClassIdx Index of the size class in TSizeClasses.
+    template <std::size_t TClassIdx>
+    std::size_t allocatedCount() const
+    {
+        return std::get<TClassIdx>(pools_).allocatedCount();
+    }
+
+private:
+    template <std::size_t TClassIdx>
+    static void release(SizeClassInPlaceAllocator& allocator, std::size_t idx)
+    {
+        typedef typename std::tuple_element<TClassIdx, Pools>::type Pool;
+        std::get<TClassIdx>(allocator.pools_).releaseSlot(
+            static_cast<typename Pool::IndexType>(idx));
+    }
+
+    Pools pools_;
+};
+
+/// @brief Monotonic "arena" allocation policy.
+/// @details Constructs the objects in the private buffer of TSize bytes,
+///          one after another, by advancing the current position. The
+///          objects are not released individually: the deleter of the
+///          returned std::unique_ptr doesn't do anything. Instead, the
+///          destructors of all the allocated objects are executed (in
+///          the reverse order of the allocations) and the whole buffer
+///          becomes available again when reset() is called. The destructors
+///          of non trivially destructible objects are registered in
+///          the intrusive list of records that are allocated in the same
+///          buffer, right after the object.
+///
+///          It is suitable for temporary objects with the same lifetime,
+///          for example the messages decoded from the single batch of
+///          input frames. The nested scopes may be created using
+///          mark() / rewind() member functions or Scope object.
+/// @tparam TSize Size of the buffer.
+/// @tparam TAlignment Alignment of the buffer, the allocated objects must
+///         not require bigger alignment. By default the alignment will
+///         be the same as alignment of "double", usually 8 bytes.
+/// @pre No allocated object may be accessed after the reset() or rewind()
+///      past its allocation.
+/// @headerfile embxx/util/Allocators.h
+template <std::size_t TSize,
+          std::size_t TAlignment = std::alignment_of<double>::value>
+class ArenaAllocator
+{
+    struct DestructRecord
+    {
+        DestructRecord* prev_;
+        void (*destruct_)(void*);
+        void* obj_;
+    };
+
+    static_assert(std::alignment_of<DestructRecord>::value <= TAlignment,
+        "Alignment of the buffer is too small");
+
+public:
+
+    /// @brief Deleter class
+    /// @details Doesn't do anything, the object is destructed by reset()
+    ///          or rewind().
+    struct Deleter
+    {
+        /// @brief Deletion operator
+        template <typename T>
+        void operator()(T* obj) const
+        {
+            static_cast<void>(obj);
+        }
+    };
+
+    /// @brief Position in the arena recorded by mark().
+    class Marker
+    {
+        friend class ArenaAllocator;
+        Marker(std::size_t offset, DestructRecord* records)
+            : offset_(offset),
+              records_(records)
+        {
+        }
+
+        std::size_t offset_;
+        DestructRecord* records_;
+    };
+
+    /// @brief Nested scope of allocations.
+    /// @details Records the current position in the arena on construction
+    ///          and rewinds to it on destruction, i.e. destructs all the
+    ///          objects allocated during the lifetime of the scope.
+    class Scope
+    {
+    public:
+        /// @brief Constructor
+        explicit Scope(ArenaAllocator& allocator)
+            : allocator_(allocator),
+              marker_(allocator.mark())
+        {
+        }
+
+        /// Copy constructor is deleted
+        Scope(const Scope&) = delete;
+
+        /// @brief Destructor
+        ~Scope()
+        {
+            allocator_.rewind(marker_);
+        }
+
+        /// Copy assignment is deleted
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ArenaAllocator& allocator_;
+        Marker marker_;
+    };
+
+    /// @brief Constructor
+    ArenaAllocator()
+        : offset_(0),
+          records_(nullptr)
+    {
+    }
+
+    /// Copy constructor is deleted
+    ArenaAllocator(const ArenaAllocator&) = delete;
+
+    /// @brief Destructor
+    /// @details Destructs all the allocated objects.
+    ~ArenaAllocator()
+    {
+        reset();
+    }
+
+    /// Copy assignment is deleted
+    ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+    /// @brief Allocation function
+    /// @details Constructs the object at the current position in the buffer
+    ///          and registers its destructor to be executed by reset().
+    /// @tparam TObj Type of object to by constructed
+    /// @tparam TArgs Types of the parameters required to create an object.
+    /// @return std::unique_ptr to constructed object with the deleter that
+    ///         doesn't do anything. Empty if there is not enough space
+    ///         left in the buffer.
+    /// @pre std::alignment_of<TObj>::value <= TAlignment.
+    template <typename TObj, typename... TArgs>
+    std::unique_ptr<TObj, Deleter> alloc(TArgs&&... args)
+    {
+        static_assert(std::alignment_of<TObj>::value <= TAlignment,
+                                "Failed alignment requirements");
+
+        static const bool TrivialDestruct =
+            std::is_trivially_destructible<TObj>::value;
+
+        std::unique_ptr<TObj, Deleter> ptr;
+        auto objOffset = alignOffset(offset_, std::alignment_of<TObj>::value);
+        auto endOffset = objOffset + sizeof(TObj);
+        auto recordOffset = alignOffset(endOffset, std::alignment_of<DestructRecord>::value);
+        if (!TrivialDestruct) {
+            endOffset = recordOffset + sizeof(DestructRecord);
+        }
+
+        if (TSize < endOffset) {
+            return std::move(ptr);
+        }
+
+        auto* buf = reinterpret_cast<std::uint8_t*>(&place_);
+        ptr.reset(new (&buf[objOffset]) TObj(std::forward<TArgs>(args)...));
+        if (!TrivialDestruct) {
+            auto* record = new (&buf[recordOffset]) DestructRecord;
+            record->prev_ = records_;
+            record->destruct_ = &ArenaAllocator::template destruct<TObj>;
+            record->obj_ = ptr.get();
+            records_ = record;
+        }
+        offset_ = endOffset;
+        return std::move(ptr);
+    }
+
+    /// @brief Same as alloc(), but returns raw pointer.
+    /// @return Pointer to constructed object, nullptr if there is not
+    ///         enough space left in the buffer.
+    template <typename TObj, typename... TArgs>
+    TObj* allocRaw(TArgs&&... args)
+    {
+        return alloc<TObj>(std::forward<TArgs>(args)...).release();
+    }
+
+    /// @brief Doesn't do anything, the object is destructed by reset()
+    ///        or rewind().
+    template <typename TObj>
+    void deallocRaw(TObj* obj)
+    {
+        static_cast<void>(obj);
+    }
+
+    /// @brief Record current position in the arena.
+    Marker mark() const
+    {
+        return Marker(offset_, records_);
+    }
+
+    /// @brief Destruct all the objects allocated after the marker was
+    ///        recorded and make their space available again.
+    /// @param[in] marker Marker returned by mark().
+    /// @pre The arena wasn't rewound past the marker since it was recorded.
+    void rewind(const Marker& marker)
+    {
+        GASSERT(marker.offset_ <= offset_);
+        while (records_ != marker.records_) {
+            GASSERT(records_ != nullptr);
+            auto* record = records_;
+            records_ = record->prev_;
+            record->destruct_(record->obj_);
+        }
+        offset_ = marker.offset_;
+    }
+
+    /// @brief Destruct all the allocated objects and make the whole buffer
+    ///        available again.
+    void reset()
+    {
+        rewind(Marker(0, nullptr));
+    }
+
+    /// @brief Number of used bytes in the buffer.
+    std::size_t usedSize() const
+    {
+        return offset_;
+    }
+
+    /// @brief Size of the buffer.
+    static constexpr std::size_t capacity()
+    {
+        return TSize;
+    }
+
+private:
+    static std::size_t alignOffset(std::size_t offset, std::size_t alignment)
+    {
+        return ((offset + alignment - 1) / alignment) * alignment;
+    }
+
+    template <typename TObj>
+    static void destruct(void* obj)
+    {
+        static_cast<TObj*>(obj)->~TObj();
+    }
+
+    typename std::aligned_storage<TSize, TAlignment>::type place_;
+    std::size_t offset_;
+    DestructRecord* records_;
+};
+
 /// @}
 
 }  // namespace util
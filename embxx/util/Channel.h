@@ -0,0 +1,419 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/Channel.h
+/// Contains Channel class definition.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <functional>
+
+#include "embxx/container/SpscStaticQueue.h"
+#include "embxx/util/Assert.h"
+#include "embxx/util/StaticFunction.h"
+#include "embxx/error/ErrorStatus.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+/// @addtogroup util
+/// @{
+
+/// @brief Bounded channel passing values to the event loop.
+/// @details Passes values through embxx::container::SpscStaticQueue, i.e.
+///          the values are moved (not copied into the handlers queue) from
+///          the producer (other event loop, thread or interrupt) to the
+///          consumer event loop. The producer doesn't acquire any lock to
+///          add new value. The consumer event loop is woken up (by posting
+///          a notification to it, which signals its condition variable)
+///          only when the channel becomes non-empty while there is
+///          a pending asyncWaitDataAvailable() request, i.e. the burst of
+///          values costs a single post() to the consumer event loop.
+/// @tparam T Type of the values.
+/// @tparam TSize Maximal number of values in the channel.
+/// @tparam TEventLoop Type of the consumer event loop, such as
+///         embxx::util::EventLoop. It must provide post() and
+///         postInterruptCtx() member functions.
+/// @tparam TWaitHandler Callback functor class to be called when data
+///         becomes available. Must be either std::function or
+///         embxx::util::StaticFunction and have
+///         "void (const embxx::error::ErrorStatus&)" signature.
+/// @pre std::atomic<std::size_t> and std::atomic<bool> must be lock-free on
+///      the target platform if sendInterruptCtx() is used.
+/// @headerfile embxx/util/Channel.h
+template <typename T,
+          std::size_t TSize,
+          typename TEventLoop,
+          typename TWaitHandler = embxx::util::StaticFunction<void (const embxx::error::ErrorStatus&)> >
+class Channel
+{
+    static_assert(0 < TSize, "Channel must have non-zero capacity");
+public:
+    /// @brief Type of the values
+    typedef T ValueType;
+
+    /// @brief Type of the consumer event loop
+    typedef TEventLoop EventLoop;
+
+    /// @brief Type of the wait handler
+    typedef TWaitHandler WaitHandler;
+
+    /// @brief Constructor
+    /// @param el Reference to the consumer event loop.
+    explicit Channel(EventLoop& el);
+
+    /// @brief Destructor
+    /// @details Destructs all the values that haven't been received.
+    ~Channel();
+
+    /// @brief Copy constructor is deleted
+    Channel(const Channel&) = delete;
+
+    /// @brief Copy assignment operator is deleted
+    Channel& operator=(const Channel&) = delete;
+
+    /// @brief Get reference to the consumer event loop.
+    EventLoop& eventLoop();
+
+    /// @brief Get maximal number of values in the channel.
+    static constexpr std::size_t capacity();
+
+    /// @brief Add new value to the channel.
+    /// @details The value is constructed in place in the channel storage
+    ///          from the provided arguments.
+    /// @param args Arguments to construct the value.
+    /// @return true in case the value was added, false if the channel is full.
+    ///         If the consumer's event loop is full and cannot accept the
+    ///         wake up notification, the value is still added and the
+    ///         notification is retried by the next successful push.
+    /// @note Thread safety: Safe with regard to consumer side functions,
+    ///       unsafe with regard to other producer side functions.
+    /// @note Exception guarantee: Basic
+    template <typename... TArgs>
+    bool emplace(TArgs&&... args);
+
+    /// @brief Add new value to the channel.
+    /// @details Equivalent to emplace(std::forward<TValue>(value)).
+    template <typename TValue>
+    bool send(TValue&& value);
+
+    /// @brief Add new value to the channel from interrupt context.
+    /// @details Same as send(), but uses postInterruptCtx() of the consumer
+    ///          event loop to wake it up.
+    template <typename TValue>
+    bool sendInterruptCtx(TValue&& value);
+
+    /// @brief Get number of values available for reception.
+    /// @note Thread safety: Safe
+    std::size_t size() const;
+
+    /// @brief Check whether there are no values available for reception.
+    /// @note Thread safety: Safe
+    bool empty() const;
+
+    /// @brief Access the first value available for reception.
+    /// @pre @code !empty() @endcode
+    /// @note Thread safety: Consumer side only.
+    ValueType& front();
+
+    /// @brief Remove the first value from the channel.
+    /// @pre @code !empty() @endcode
+    /// @note Thread safety: Consumer side only.
+    void popFront();
+
+    /// @brief Receive single value.
+    /// @param[out] value Value to move the received value to.
+    /// @return true in case the value was received, false if the channel
+    ///         is empty.
+    /// @note Thread safety: Consumer side only.
+    bool receive(ValueType& value);
+
+    /// @brief Receive multiple values.
+    /// @details Invokes provided function for every available value
+    ///          passing it as rvalue reference. The space of all the
+    ///          received values is released to the producer at once
+    ///          after the last invocation.
+    /// @param func Functor with "void (ValueType&&)" signature.
+    /// @param maxCount Maximal number of values to receive, 0 means all
+    ///        the available ones.
+    /// @return Number of received values.
+    /// @note Thread safety: Consumer side only.
+    template <typename TFunc>
+    std::size_t receiveBatch(TFunc&& func, std::size_t maxCount = 0);
+
+    /// @brief Perform asynchronous wait until the data becomes available.
+    /// @details The function records the callback object and returns
+    ///          immediately. The callback will be called in the context of
+    ///          the consumer event loop with
+    ///          embxx::error::ErrorCode::Success status when there is at least
+    ///          one value available for reception.
+    /// @param func Callback functor object,
+    ///        must have "void (const embxx::error::ErrorStatus&)" signature.
+    /// @pre All the previous asynchronous wait request are complete (their
+    ///      callback has been executed).
+    /// @note Thread safety: Consumer side only.
+    template <typename TFunc>
+    void asyncWaitDataAvailable(TFunc&& func);
+
+    /// @brief Cancel pending asynchronous wait request.
+    /// @details The callback of the pending request will be called with
+    ///          embxx::error::ErrorCode::Aborted status.
+    /// @note Thread safety: Consumer side only.
+    void cancelWait();
+
+private:
+    typedef embxx::container::SpscStaticQueue<ValueType, TSize> Queue;
+
+    template <bool TInterruptCtx, typename... TArgs>
+    bool push(TArgs&&... args);
+
+    template <typename TTask>
+    bool postToLoop(TTask&& task, std::false_type);
+
+    template <typename TTask>
+    bool postToLoop(TTask&& task, std::true_type);
+
+    void checkAvailable();
+    void invokeHandler(const embxx::error::ErrorStatus& status);
+
+    EventLoop& el_;
+    Queue queue_;
+    std::atomic<bool> waiting_;
+    WaitHandler waitHandler_;
+};
+
+/// @}
+
+// Implementation
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+Channel<T, TSize, TEventLoop, TWaitHandler>::Channel(EventLoop& el)
+    : el_(el),
+      waiting_(false)
+{
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+Channel<T, TSize, TEventLoop, TWaitHandler>::~Channel()
+{
+    queue_.clear();
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+typename Channel<T, TSize, TEventLoop, TWaitHandler>::EventLoop&
+Channel<T, TSize, TEventLoop, TWaitHandler>::eventLoop()
+{
+    return el_;
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+constexpr std::size_t Channel<T, TSize, TEventLoop, TWaitHandler>::capacity()
+{
+    return TSize;
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+template <typename... TArgs>
+bool Channel<T, TSize, TEventLoop, TWaitHandler>::emplace(TArgs&&... args)
+{
+    return push<false>(std::forward<TArgs>(args)...);
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+template <typename TValue>
+bool Channel<T, TSize, TEventLoop, TWaitHandler>::send(TValue&& value)
+{
+    return push<false>(std::forward<TValue>(value));
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+template <typename TValue>
+bool Channel<T, TSize, TEventLoop, TWaitHandler>::sendInterruptCtx(
+    TValue&& value)
+{
+    return push<true>(std::forward<TValue>(value));
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+std::size_t Channel<T, TSize, TEventLoop, TWaitHandler>::size() const
+{
+    return queue_.size();
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+bool Channel<T, TSize, TEventLoop, TWaitHandler>::empty() const
+{
+    return queue_.empty();
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+typename Channel<T, TSize, TEventLoop, TWaitHandler>::ValueType&
+Channel<T, TSize, TEventLoop, TWaitHandler>::front()
+{
+    GASSERT(!empty());
+    return queue_.front();
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+void Channel<T, TSize, TEventLoop, TWaitHandler>::popFront()
+{
+    GASSERT(!empty());
+    queue_.popFront();
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+bool Channel<T, TSize, TEventLoop, TWaitHandler>::receive(ValueType& value)
+{
+    if (empty()) {
+        return false;
+    }
+
+    value = std::move(front());
+    popFront();
+    return true;
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+template <typename TFunc>
+std::size_t Channel<T, TSize, TEventLoop, TWaitHandler>::receiveBatch(
+    TFunc&& func,
+    std::size_t maxCount)
+{
+    if (maxCount == 0) {
+        maxCount = std::numeric_limits<std::size_t>::max();
+    }
+
+    auto count = std::min(size(), maxCount);
+    for (auto idx = 0U; idx < count; ++idx) {
+        func(std::move(queue_[idx]));
+    }
+
+    queue_.popFront(count);
+    return count;
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+template <typename TFunc>
+void Channel<T, TSize, TEventLoop, TWaitHandler>::asyncWaitDataAvailable(
+    TFunc&& func)
+{
+    GASSERT(!waitHandler_);
+    waitHandler_ = std::forward<TFunc>(func);
+    checkAvailable();
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+void Channel<T, TSize, TEventLoop, TWaitHandler>::cancelWait()
+{
+    waiting_.store(false, std::memory_order_relaxed);
+    invokeHandler(embxx::error::ErrorCode::Aborted);
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+template <bool TInterruptCtx, typename... TArgs>
+bool Channel<T, TSize, TEventLoop, TWaitHandler>::push(TArgs&&... args)
+{
+    if (!queue_.emplaceBack(std::forward<TArgs>(args)...)) {
+        return false;
+    }
+
+    // Pairs with the fence in checkAvailable(): either the consumer sees
+    // the new value or the producer sees the "waiting" flag.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((!waiting_.load(std::memory_order_relaxed)) ||
+        (!waiting_.exchange(false, std::memory_order_acquire))) {
+        return true;
+    }
+
+    bool result = postToLoop(
+        [this]()
+        {
+            checkAvailable();
+        },
+        std::integral_constant<bool, TInterruptCtx>());
+    if (!result) {
+        // The value is in the channel, but the consumer is still waiting,
+        // the next push will retry the notification.
+        waiting_.store(true, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+template <typename TTask>
+bool Channel<T, TSize, TEventLoop, TWaitHandler>::postToLoop(
+    TTask&& task,
+    std::false_type)
+{
+    return el_.post(std::forward<TTask>(task));
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+template <typename TTask>
+bool Channel<T, TSize, TEventLoop, TWaitHandler>::postToLoop(
+    TTask&& task,
+    std::true_type)
+{
+    return el_.postInterruptCtx(std::forward<TTask>(task));
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+void Channel<T, TSize, TEventLoop, TWaitHandler>::checkAvailable()
+{
+    if (!waitHandler_) {
+        return; // Stale notification of cancelled request
+    }
+
+    if (!empty()) {
+        invokeHandler(embxx::error::ErrorCode::Success);
+        return;
+    }
+
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (empty()) {
+        return; // The producer will post the notification
+    }
+
+    if (waiting_.exchange(false, std::memory_order_acquire)) {
+        invokeHandler(embxx::error::ErrorCode::Success);
+    }
+}
+
+template <typename T, std::size_t TSize, typename TEventLoop, typename TWaitHandler>
+void Channel<T, TSize, TEventLoop, TWaitHandler>::invokeHandler(
+    const embxx::error::ErrorStatus& status)
+{
+    if (waitHandler_) {
+        auto postResult = el_.post(std::bind(std::move(waitHandler_), status));
+        static_cast<void>(postResult);
+        GASSERT(postResult);
+        GASSERT(!waitHandler_);
+    }
+}
+
+}  // namespace util
+
+}  // namespace embxx
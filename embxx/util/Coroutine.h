@@ -0,0 +1,478 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/Coroutine.h
+/// Contains C++20 coroutine adapters for the event loop and asynchronous
+/// operations of the drivers.
+/// @details The contents are available only when compiled with the C++20
+///          coroutines support, in which case EMBXX_HAS_COROUTINES
+///          macro is defined.
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define EMBXX_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef EMBXX_HAS_COROUTINES
+
+#include <cstddef>
+#include <coroutine>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "embxx/util/Assert.h"
+#include "embxx/util/StaticPoolAllocator.h"
+#include "embxx/error/ErrorStatus.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+/// @addtogroup util
+/// @{
+
+/// @brief Return type of the coroutines executed by the event loop.
+/// @details The coroutine starts its execution immediately when called
+///          and destroys its frame when complete. Nobody awaits its
+///          completion (i.e. "fire and forget"). The frames are
+///          allocated from the static pool of TFrameCount blocks
+///          of TFrameSize bytes each, no dynamic memory allocation
+///          is involved:
+///          @code
+///          struct MyTag {};
+///          typedef embxx::util::CoTask<MyTag, 256, 4> Task;
+///
+///          Task pollSensor(Timer& timer)
+///          {
+///              while (true) {
+///                  auto es = co_await embxx::util::asyncWait(timer, std::chrono::milliseconds(10));
+///                  if (es) {
+///                      co_return;
+///                  }
+///                  ...
+///              }
+///          }
+///          @endcode
+/// @tparam TTag Tag class to separate the frame pools.
+/// @tparam TFrameSize Maximal size in bytes of the coroutine frame. If the
+///         compiler requires bigger frame, the allocation fails.
+/// @tparam TFrameCount Maximal number of simultaneously running coroutines.
+/// @headerfile embxx/util/Coroutine.h
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+class CoTask
+{
+public:
+    /// @cond DOCUMENT_CO_TASK_PROMISE
+    class promise_type
+    {
+    public:
+        static void* operator new(std::size_t size) noexcept;
+        static void operator delete(void* ptr, std::size_t size) noexcept;
+        static CoTask get_return_object_on_allocation_failure() noexcept;
+
+        CoTask get_return_object() noexcept;
+        std::suspend_never initial_suspend() noexcept;
+        std::suspend_never final_suspend() noexcept;
+        void return_void() noexcept;
+        void unhandled_exception() noexcept;
+    };
+    /// @endcond
+
+    /// @brief Check whether the coroutine has been started.
+    /// @return false in case the frame of the coroutine couldn't be
+    ///         allocated, true otherwise.
+    bool isValid() const;
+
+    /// @brief Get maximal size of the coroutine frame.
+    static constexpr std::size_t frameSize();
+
+    /// @brief Get maximal number of simultaneously running coroutines.
+    static constexpr std::size_t frameCount();
+
+private:
+    typedef typename
+        std::aligned_storage<
+            TFrameSize,
+            alignof(std::max_align_t)
+        >::type Frame;
+
+    typedef StaticPoolAllocator<TTag, Frame, TFrameCount> FrameAllocator;
+
+    explicit CoTask(bool valid);
+
+    bool valid_;
+};
+
+/// @cond DOCUMENT_CO_AWAITERS
+namespace details
+{
+
+template <typename... TResults>
+struct CoResult
+{
+    typedef std::tuple<typename std::decay<TResults>::type...> Type;
+
+    static Type get(Type& results)
+    {
+        return std::move(results);
+    }
+};
+
+template <typename TResult>
+struct CoResult<TResult>
+{
+    typedef typename std::decay<TResult>::type Type;
+
+    static Type get(Type& result)
+    {
+        return std::move(result);
+    }
+};
+
+}  // namespace details
+/// @endcond
+
+/// @brief Awaitable wrapper of the asynchronous operation.
+/// @details When awaited, invokes the initiating functor providing it with
+///          the completion callback. The callback only stores
+///          the results and resumes the awaiting coroutine, i.e. it is
+///          invoked directly by the event loop and it occupies only two
+///          pointers when stored as embxx::util::StaticFunction.
+/// @tparam TInitiator Initiating functor, receives the completion callback.
+/// @tparam TResults Types of the parameters passed to completion callback.
+///         The result of co_await expression is the value of the single
+///         parameter or std::tuple of all of them.
+/// @headerfile embxx/util/Coroutine.h
+template <typename TInitiator, typename... TResults>
+class AsyncOpAwaiter
+{
+    typedef details::CoResult<TResults...> Result;
+public:
+    /// @brief Constructor
+    explicit AsyncOpAwaiter(TInitiator&& initiator);
+
+    /// @cond DOCUMENT_CO_AWAITER_INTERFACE
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<> handle);
+    typename Result::Type await_resume();
+    /// @endcond
+
+private:
+    TInitiator initiator_;
+    typename Result::Type results_;
+};
+
+/// @brief Create awaitable wrapper of the asynchronous operation.
+/// @details The initiator is called with the completion callback:
+///          @code
+///          auto status = co_await embxx::util::makeAsyncOp<const embxx::error::ErrorStatus&>(
+///              [&buf](auto&& callback)
+///              {
+///                  buf.asyncWaitAvailableCapacity(10, std::move(callback));
+///              });
+///          @endcode
+/// @tparam TResults Types of the parameters passed to completion callback.
+/// @param initiator Initiating functor.
+/// @related AsyncOpAwaiter
+template <typename... TResults, typename TInitiator>
+AsyncOpAwaiter<typename std::decay<TInitiator>::type, TResults...>
+makeAsyncOp(TInitiator&& initiator);
+
+/// @brief Awaitable that reschedules the coroutine to the event loop.
+/// @details Posts the continuation of the coroutine to the provided event
+///          loop allowing other pending handlers to be executed.
+///          If the post fails, the coroutine continues immediately.
+/// @tparam TEventLoop Type of the event loop.
+/// @headerfile embxx/util/Coroutine.h
+template <typename TEventLoop>
+class PostAwaiter
+{
+public:
+    /// @brief Constructor
+    explicit PostAwaiter(TEventLoop& el);
+
+    /// @cond DOCUMENT_CO_AWAITER_INTERFACE
+    bool await_ready() const noexcept;
+    bool await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const noexcept;
+    /// @endcond
+
+private:
+    TEventLoop& el_;
+};
+
+/// @brief Reschedule the coroutine to the event loop.
+/// @details Usage:
+///          @code co_await embxx::util::post(el); @endcode
+/// @related PostAwaiter
+template <typename TEventLoop>
+PostAwaiter<TEventLoop> post(TEventLoop& el);
+
+/// @brief Awaitable wait of the timer (such as
+///        embxx::driver::TimerMgr::Timer).
+/// @details Usage:
+///          @code
+///          auto status = co_await embxx::util::asyncWait(timer, std::chrono::milliseconds(10));
+///          @endcode
+/// @return Awaitable resulting in embxx::error::ErrorStatus.
+template <typename TTimer, typename TDuration>
+auto asyncWait(TTimer& timer, const TDuration& waitTime);
+
+/// @brief Awaitable read of the character driver (such as
+///        embxx::driver::Character).
+/// @details Usage:
+///          @code
+///          auto [status, bytesRead] = co_await embxx::util::asyncRead(uart, buf, sizeof(buf));
+///          @endcode
+/// @return Awaitable resulting in std::tuple of embxx::error::ErrorStatus and
+///         number of read bytes.
+template <typename TDriver, typename TChar>
+auto asyncRead(TDriver& driver, TChar* buf, std::size_t size);
+
+/// @brief Awaitable write of the character driver (such as
+///        embxx::driver::Character).
+/// @return Awaitable resulting in std::tuple of embxx::error::ErrorStatus and
+///         number of written bytes.
+template <typename TDriver, typename TChar>
+auto asyncWrite(TDriver& driver, const TChar* buf, std::size_t size);
+
+/// @brief Awaitable wait for the output buffer capacity (such as
+///        embxx::io::OutStreamBuf).
+/// @return Awaitable resulting in embxx::error::ErrorStatus.
+template <typename TOutBuf>
+auto asyncWaitAvailableCapacity(TOutBuf& buf, std::size_t capacity);
+
+/// @}
+
+// Implementation
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+void* CoTask<TTag, TFrameSize, TFrameCount>::promise_type::operator new(
+    std::size_t size) noexcept
+{
+    if (TFrameSize < size) {
+        GASSERT(!"Coroutine frame is too big, increase TFrameSize");
+        return nullptr;
+    }
+
+    // The exhausted pool results in nullptr, which is reported via
+    // get_return_object_on_allocation_failure(). The frame is a new object
+    // in the pool storage, laundering also prevents the compiler from
+    // treating its release as deallocation of the static pool.
+    return std::launder(FrameAllocator().allocate(1));
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+void CoTask<TTag, TFrameSize, TFrameCount>::promise_type::operator delete(
+    void* ptr,
+    std::size_t size) noexcept
+{
+    static_cast<void>(size);
+    FrameAllocator().deallocate(reinterpret_cast<Frame*>(ptr), 1);
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+CoTask<TTag, TFrameSize, TFrameCount>
+CoTask<TTag, TFrameSize, TFrameCount>::promise_type::get_return_object_on_allocation_failure() noexcept
+{
+    return CoTask(false);
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+CoTask<TTag, TFrameSize, TFrameCount>
+CoTask<TTag, TFrameSize, TFrameCount>::promise_type::get_return_object() noexcept
+{
+    return CoTask(true);
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+std::suspend_never
+CoTask<TTag, TFrameSize, TFrameCount>::promise_type::initial_suspend() noexcept
+{
+    return std::suspend_never();
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+std::suspend_never
+CoTask<TTag, TFrameSize, TFrameCount>::promise_type::final_suspend() noexcept
+{
+    return std::suspend_never();
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+void CoTask<TTag, TFrameSize, TFrameCount>::promise_type::return_void() noexcept
+{
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+void CoTask<TTag, TFrameSize, TFrameCount>::promise_type::unhandled_exception() noexcept
+{
+    GASSERT(!"Unhandled exception in coroutine");
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+bool CoTask<TTag, TFrameSize, TFrameCount>::isValid() const
+{
+    return valid_;
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+constexpr std::size_t CoTask<TTag, TFrameSize, TFrameCount>::frameSize()
+{
+    return TFrameSize;
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+constexpr std::size_t CoTask<TTag, TFrameSize, TFrameCount>::frameCount()
+{
+    return TFrameCount;
+}
+
+template <typename TTag, std::size_t TFrameSize, std::size_t TFrameCount>
+CoTask<TTag, TFrameSize, TFrameCount>::CoTask(bool valid)
+    : valid_(valid)
+{
+}
+
+template <typename TInitiator, typename... TResults>
+AsyncOpAwaiter<TInitiator, TResults...>::AsyncOpAwaiter(TInitiator&& initiator)
+    : initiator_(std::move(initiator))
+{
+}
+
+template <typename TInitiator, typename... TResults>
+bool AsyncOpAwaiter<TInitiator, TResults...>::await_ready() const noexcept
+{
+    return false;
+}
+
+template <typename TInitiator, typename... TResults>
+void AsyncOpAwaiter<TInitiator, TResults...>::await_suspend(
+    std::coroutine_handle<> handle)
+{
+    // The coroutine may be resumed (and the awaiter destructed) before
+    // the initiator returns, no members may be accessed afterwards.
+    auto init = std::move(initiator_);
+    init(
+        [this, handle](TResults... results)
+        {
+            results_ = typename Result::Type(std::forward<TResults>(results)...);
+            handle.resume();
+        });
+}
+
+template <typename TInitiator, typename... TResults>
+typename AsyncOpAwaiter<TInitiator, TResults...>::Result::Type
+AsyncOpAwaiter<TInitiator, TResults...>::await_resume()
+{
+    return Result::get(results_);
+}
+
+template <typename... TResults, typename TInitiator>
+AsyncOpAwaiter<typename std::decay<TInitiator>::type, TResults...>
+makeAsyncOp(TInitiator&& initiator)
+{
+    typedef typename std::decay<TInitiator>::type InitiatorType;
+    return AsyncOpAwaiter<InitiatorType, TResults...>(
+        InitiatorType(std::forward<TInitiator>(initiator)));
+}
+
+template <typename TEventLoop>
+PostAwaiter<TEventLoop>::PostAwaiter(TEventLoop& el)
+    : el_(el)
+{
+}
+
+template <typename TEventLoop>
+bool PostAwaiter<TEventLoop>::await_ready() const noexcept
+{
+    return false;
+}
+
+template <typename TEventLoop>
+bool PostAwaiter<TEventLoop>::await_suspend(std::coroutine_handle<> handle)
+{
+    bool result = el_.post(
+        [handle]()
+        {
+            handle.resume();
+        });
+    return result;
+}
+
+template <typename TEventLoop>
+void PostAwaiter<TEventLoop>::await_resume() const noexcept
+{
+}
+
+template <typename TEventLoop>
+PostAwaiter<TEventLoop> post(TEventLoop& el)
+{
+    return PostAwaiter<TEventLoop>(el);
+}
+
+template <typename TTimer, typename TDuration>
+auto asyncWait(TTimer& timer, const TDuration& waitTime)
+{
+    return makeAsyncOp<const embxx::error::ErrorStatus&>(
+        [&timer, waitTime](auto&& callback)
+        {
+            timer.asyncWait(waitTime, std::move(callback));
+        });
+}
+
+template <typename TDriver, typename TChar>
+auto asyncRead(TDriver& driver, TChar* buf, std::size_t size)
+{
+    return makeAsyncOp<const embxx::error::ErrorStatus&, std::size_t>(
+        [&driver, buf, size](auto&& callback)
+        {
+            driver.asyncRead(buf, size, std::move(callback));
+        });
+}
+
+template <typename TDriver, typename TChar>
+auto asyncWrite(TDriver& driver, const TChar* buf, std::size_t size)
+{
+    return makeAsyncOp<const embxx::error::ErrorStatus&, std::size_t>(
+        [&driver, buf, size](auto&& callback)
+        {
+            driver.asyncWrite(buf, size, std::move(callback));
+        });
+}
+
+template <typename TOutBuf>
+auto asyncWaitAvailableCapacity(TOutBuf& buf, std::size_t capacity)
+{
+    return makeAsyncOp<const embxx::error::ErrorStatus&>(
+        [&buf, capacity](auto&& callback)
+        {
+            buf.asyncWaitAvailableCapacity(capacity, std::move(callback));
+        });
+}
+
+}  // namespace util
+
+}  // namespace embxx
+
+#endif // #ifdef EMBXX_HAS_COROUTINES
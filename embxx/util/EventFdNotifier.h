@@ -0,0 +1,138 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/EventFdNotifier.h
+/// This file contains the definition and implementation of the Linux eventfd
+/// based notifier that can wake up a thread in other process.
+
+#pragma once
+
+#ifndef __linux__
+#error "EventFdNotifier is available only on Linux"
+#endif // #ifndef __linux__
+
+#include <cstdint>
+#include <cerrno>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "embxx/util/Assert.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+/// @addtogroup util
+/// @{
+
+/// @brief Notifier based on Linux eventfd.
+/// @details Intended to be used with
+///          embxx::container::SharedSpscStaticQueue, which is placed in
+///          shared memory, to wake up the consumer in other process.
+///          The file descriptor is shared between the processes either by
+///          inheriting it on fork() or by passing it over UNIX domain socket,
+///          then wrapped by the object in the receiving process.
+///          The notifications are counted by the kernel, i.e. notify()
+///          invoked before wait() is not lost.
+/// @headerfile embxx/util/EventFdNotifier.h
+class EventFdNotifier
+{
+public:
+    /// @brief Default constructor.
+    /// @details Creates new eventfd object. Use valid() to check whether
+    ///          the creation was successful.
+    EventFdNotifier()
+        : fd_(::eventfd(0, 0))
+    {
+    }
+
+    /// @brief Constructor
+    /// @details Takes ownership of the existing eventfd descriptor.
+    /// @param[in] fd eventfd file descriptor.
+    explicit EventFdNotifier(int fd)
+        : fd_(fd)
+    {
+    }
+
+    /// @brief Copy constructor is deleted.
+    EventFdNotifier(const EventFdNotifier&) = delete;
+
+    /// @brief Destructor
+    /// @details Closes the owned descriptor.
+    ~EventFdNotifier()
+    {
+        if (valid()) {
+            ::close(fd_);
+        }
+    }
+
+    /// @brief Copy assignment operator is deleted.
+    EventFdNotifier& operator=(const EventFdNotifier&) = delete;
+
+    /// @brief Check whether the object owns valid descriptor.
+    bool valid() const
+    {
+        return 0 <= fd_;
+    }
+
+    /// @brief Get the owned descriptor.
+    int fd() const
+    {
+        return fd_;
+    }
+
+    /// @brief Wake up the waiting thread.
+    /// @note Thread safety: Safe
+    void notify()
+    {
+        GASSERT(valid());
+        std::uint64_t value = 1;
+        while (::write(fd_, &value, sizeof(value)) < 0) {
+            if (errno != EINTR) {
+                GASSERT(!"Failed to write eventfd");
+                break;
+            }
+        }
+    }
+
+    /// @brief Block until notify() is invoked by any thread or process.
+    /// @details Consumes all the pending notifications.
+    /// @note Thread safety: Safe
+    void wait()
+    {
+        GASSERT(valid());
+        std::uint64_t value = 0;
+        while (::read(fd_, &value, sizeof(value)) < 0) {
+            if (errno != EINTR) {
+                GASSERT(!"Failed to read eventfd");
+                break;
+            }
+        }
+    }
+
+private:
+    int fd_;
+};
+
+/// @}
+
+}  // namespace util
+
+}  // namespace embxx
@@ -25,9 +25,16 @@
 #include <mutex>
 #include <new>
 #include <functional>
+#include <iterator>
+#include <utility>
+#include <limits>
+#include <algorithm>
 
 #include "embxx/container/StaticQueue.h"
 #include "embxx/util/ScopeGuard.h"
+#include "embxx/util/EventLoopStats.h"
+#include "embxx/util/StaticFunction.h"
+#include "embxx/error/ErrorStatus.h"
 
 namespace embxx
 {
@@ -35,6 +42,923 @@ namespace embxx
 namespace util
 {
 
+namespace details
+{
+
+/// @cond DOCUMENT_EVENT_LOOP_QUEUE
+template <std::size_t TSize>
+class EventLoopQueue
+{
+    // Every record starts with a single "ops" function pointer followed
+    // by the handler object itself. The null "ops" marks unused space at
+    // the end of the storage area (when the queue wraps around).
+    enum class RecordOp
+    {
+        Exec, // Execute and destroy the handler, return record size
+        Destroy, // Destroy the handler, return record size
+        MoveTo, // Move the handler to target queue, return 0 if not moved
+        Poll, // Invoke the poller, destroy it and return record size if
+              // complete, return 0 otherwise
+        GetSize // Return record size
+    };
+
+    typedef std::size_t (*RecordOps)(RecordOp op, void* payload, void* target);
+
+    typedef typename
+        std::aligned_storage<
+            sizeof(RecordOps),
+            std::alignment_of<RecordOps>::value
+        >::type ArrayElemType;
+
+    static_assert(sizeof(ArrayElemType) == sizeof(RecordOps),
+        "Record header is expected to occupy a single element");
+
+    template <typename TTask>
+    struct RecordSize
+    {
+        static const std::size_t Value =
+            1 + ((sizeof(TTask) - 1) / sizeof(ArrayElemType)) + 1;
+    };
+
+    static const std::size_t ArraySize = TSize / sizeof(ArrayElemType);
+    typedef embxx::container::StaticQueue<ArrayElemType, ArraySize> Queue;
+    typedef typename Queue::LinearisedIterator QueueIter;
+    typedef typename Queue::LinearisedIteratorRange QueueRange;
+
+public:
+    typedef std::pair<QueueRange, QueueRange> Snapshot;
+
+    EventLoopQueue() = default;
+
+    ~EventLoopQueue();
+
+    bool isEmpty() const;
+
+    std::size_t usedBytes() const;
+
+    std::size_t availableBytes() const;
+
+    template <typename TTask>
+    bool push(TTask&& task);
+
+    template <typename TTask>
+    bool pushPinned(TTask&& task);
+
+    template <typename TTarget, typename TTask>
+    bool pushMovableTo(TTask&& task);
+
+    template <typename TRecord, typename TArg>
+    bool emplace(TArg&& arg);
+
+    template <typename TTarget, typename TRecord, typename TArg>
+    bool emplaceMovableTo(TArg&& arg);
+
+    template <typename TPoller>
+    bool pushPoller(TPoller&& poller);
+
+    template <typename TRecord>
+    static constexpr bool canHold()
+    {
+        return RecordSize<TRecord>::Value <= ArraySize;
+    }
+
+    Snapshot snapshot();
+
+    Snapshot snapshot(std::size_t budget);
+
+    static std::size_t snapshotSize(const Snapshot& snap);
+
+    template <typename TStopFlag>
+    std::size_t exec(
+        const Snapshot& snap,
+        std::size_t budget,
+        std::size_t& execCount,
+        const TStopFlag& stopped);
+
+    void release(std::size_t size);
+
+    bool stealTo(EventLoopQueue& other, std::size_t skipSize);
+
+    template <typename TOther>
+    bool moveFrontTo(TOther& other);
+
+    std::size_t poll(const Snapshot& snap, std::size_t startIdx, std::size_t budget);
+
+    void releaseHoles();
+
+    void clear();
+
+private:
+    template <typename TRecord, RecordOps TOps, typename TArg>
+    bool pushRecord(TArg&& arg);
+
+    template <typename TTask, bool TPinned, typename TTarget>
+    static std::size_t taskOps(RecordOp op, void* payload, void* target);
+
+    template <typename TPoller>
+    static std::size_t pollerOps(RecordOp op, void* payload, void* target);
+
+    static std::size_t holeOps(RecordOp op, void* payload, void* target);
+
+    std::size_t invokeRecord(QueueIter iter, RecordOp op, void* target = nullptr);
+
+    static bool isUnused(QueueIter iter);
+
+    void makeHole(QueueIter iter, std::size_t recordSize);
+
+    void pollRange(
+        const QueueRange& range,
+        std::size_t fromIdx,
+        std::size_t toIdx,
+        std::size_t& liveIdx,
+        std::size_t& budget,
+        std::size_t& nextIdx);
+
+    ArrayElemType* getAllocPlace(std::size_t requiredQueueSize);
+
+    void limitRange(QueueRange& range, std::size_t& budget);
+
+    template <typename TStopFlag>
+    std::size_t execRange(
+        const QueueRange& range,
+        std::size_t budget,
+        std::size_t& execCount,
+        const TStopFlag& stopped);
+
+    void destroyRange(const QueueRange& range);
+
+    Queue queue_;
+};
+
+template <std::size_t TSize>
+EventLoopQueue<TSize>::~EventLoopQueue()
+{
+    clear();
+}
+
+template <std::size_t TSize>
+bool EventLoopQueue<TSize>::isEmpty() const
+{
+    return queue_.isEmpty();
+}
+
+template <std::size_t TSize>
+std::size_t EventLoopQueue<TSize>::usedBytes() const
+{
+    return queue_.size() * sizeof(ArrayElemType);
+}
+
+template <std::size_t TSize>
+std::size_t EventLoopQueue<TSize>::availableBytes() const
+{
+    return (queue_.capacity() - queue_.size()) * sizeof(ArrayElemType);
+}
+
+template <std::size_t TSize>
+template <typename TTask>
+bool EventLoopQueue<TSize>::push(TTask&& task)
+{
+    typedef typename std::decay<TTask>::type TaskType;
+    return emplace<TaskType>(std::forward<TTask>(task));
+}
+
+template <std::size_t TSize>
+template <typename TTask>
+bool EventLoopQueue<TSize>::pushPinned(TTask&& task)
+{
+    typedef typename std::decay<TTask>::type TaskType;
+    return pushRecord<TaskType, &EventLoopQueue::taskOps<TaskType, true, EventLoopQueue> >(
+        std::forward<TTask>(task));
+}
+
+template <std::size_t TSize>
+template <typename TTarget, typename TTask>
+bool EventLoopQueue<TSize>::pushMovableTo(TTask&& task)
+{
+    typedef typename std::decay<TTask>::type TaskType;
+    return emplaceMovableTo<TTarget, TaskType>(std::forward<TTask>(task));
+}
+
+template <std::size_t TSize>
+template <typename TRecord, typename TArg>
+bool EventLoopQueue<TSize>::emplace(TArg&& arg)
+{
+    return pushRecord<TRecord, &EventLoopQueue::taskOps<TRecord, false, EventLoopQueue> >(
+        std::forward<TArg>(arg));
+}
+
+template <std::size_t TSize>
+template <typename TTarget, typename TRecord, typename TArg>
+bool EventLoopQueue<TSize>::emplaceMovableTo(TArg&& arg)
+{
+    return pushRecord<TRecord, &EventLoopQueue::taskOps<TRecord, false, TTarget> >(
+        std::forward<TArg>(arg));
+}
+
+template <std::size_t TSize>
+template <typename TPoller>
+bool EventLoopQueue<TSize>::pushPoller(TPoller&& poller)
+{
+    typedef typename std::decay<TPoller>::type PollerType;
+    return pushRecord<PollerType, &EventLoopQueue::pollerOps<PollerType> >(
+        std::forward<TPoller>(poller));
+}
+
+template <std::size_t TSize>
+typename EventLoopQueue<TSize>::Snapshot EventLoopQueue<TSize>::snapshot()
+{
+    return Snapshot(queue_.arrayOne(), queue_.arrayTwo());
+}
+
+template <std::size_t TSize>
+typename EventLoopQueue<TSize>::Snapshot EventLoopQueue<TSize>::snapshot(
+    std::size_t budget)
+{
+    auto snap = snapshot();
+    if (budget == 0) {
+        return snap;
+    }
+
+    limitRange(snap.first, budget);
+    if (budget == 0) {
+        snap.second.second = snap.second.first;
+    }
+    else {
+        limitRange(snap.second, budget);
+    }
+    return snap;
+}
+
+template <std::size_t TSize>
+std::size_t EventLoopQueue<TSize>::snapshotSize(const Snapshot& snap)
+{
+    return
+        static_cast<std::size_t>(std::distance(snap.first.first, snap.first.second)) +
+        static_cast<std::size_t>(std::distance(snap.second.first, snap.second.second));
+}
+
+template <std::size_t TSize>
+template <typename TStopFlag>
+std::size_t EventLoopQueue<TSize>::exec(
+    const Snapshot& snap,
+    std::size_t budget,
+    std::size_t& execCount,
+    const TStopFlag& stopped)
+{
+    auto execSize = execRange(snap.first, budget, execCount, stopped);
+    if (execSize ==
+            static_cast<std::size_t>(std::distance(snap.first.first, snap.first.second))) {
+        execSize += execRange(snap.second, budget, execCount, stopped);
+    }
+    return execSize;
+}
+
+template <std::size_t TSize>
+void EventLoopQueue<TSize>::release(std::size_t size)
+{
+    queue_.popFront(size);
+}
+
+template <std::size_t TSize>
+bool EventLoopQueue<TSize>::stealTo(EventLoopQueue& other, std::size_t skipSize)
+{
+    auto idx = skipSize;
+    while (idx < queue_.size()) {
+        // Records never span the end of the storage area, so every one of
+        // them is contiguous in memory.
+        auto iter = &queue_[idx];
+        auto recordSize = invokeRecord(iter, RecordOp::GetSize);
+        GASSERT((idx + recordSize) <= queue_.size());
+        if (invokeRecord(iter, RecordOp::MoveTo, &other) != 0) {
+            makeHole(iter, recordSize);
+            return true;
+        }
+        idx += recordSize;
+    }
+    return false;
+}
+
+template <std::size_t TSize>
+template <typename TOther>
+bool EventLoopQueue<TSize>::moveFrontTo(TOther& other)
+{
+    while (!queue_.isEmpty()) {
+        auto iter = &queue_.front();
+        auto recordSize = invokeRecord(iter, RecordOp::GetSize);
+        if (isUnused(iter)) {
+            queue_.popFront(recordSize);
+            continue;
+        }
+
+        if (invokeRecord(iter, RecordOp::MoveTo, &other) == 0) {
+            return false;
+        }
+
+        queue_.popFront(recordSize);
+        return true;
+    }
+    return false;
+}
+
+template <std::size_t TSize>
+std::size_t EventLoopQueue<TSize>::poll(
+    const Snapshot& snap,
+    std::size_t startIdx,
+    std::size_t budget)
+{
+    if (budget == 0) {
+        budget = std::numeric_limits<std::size_t>::max();
+    }
+
+    // Pollers are evaluated starting from the one that follows the
+    // last one evaluated in the previous cycle, then wrapping around to
+    // the beginning.
+    auto nextIdx = startIdx;
+    std::size_t liveIdx = 0;
+    auto maxIdx = std::numeric_limits<std::size_t>::max();
+    pollRange(snap.first, startIdx, maxIdx, liveIdx, budget, nextIdx);
+    pollRange(snap.second, startIdx, maxIdx, liveIdx, budget, nextIdx);
+
+    if (startIdx != 0) {
+        liveIdx = 0;
+        pollRange(snap.first, 0, startIdx, liveIdx, budget, nextIdx);
+        pollRange(snap.second, 0, startIdx, liveIdx, budget, nextIdx);
+    }
+    return nextIdx;
+}
+
+template <std::size_t TSize>
+void EventLoopQueue<TSize>::releaseHoles()
+{
+    // Unused records at both ends of the queue are released, the ones
+    // in the middle get released when they reach either of the ends.
+    auto snap = snapshot();
+    std::size_t offset = 0;
+    std::size_t usedBegin = queue_.size();
+    std::size_t usedEnd = 0;
+    for (auto* range : {&snap.first, &snap.second}) {
+        auto iter = range->first;
+        while (iter != range->second) {
+            auto recordSize = invokeRecord(iter, RecordOp::GetSize);
+            if (!isUnused(iter)) {
+                usedBegin = std::min(usedBegin, offset);
+                usedEnd = offset + recordSize;
+            }
+            offset += recordSize;
+            iter += recordSize;
+        }
+    }
+
+    GASSERT(offset == queue_.size());
+    if (usedEnd == 0) {
+        queue_.popFront(offset);
+        return;
+    }
+
+    queue_.popBack(offset - usedEnd);
+    queue_.popFront(usedBegin);
+}
+
+template <std::size_t TSize>
+void EventLoopQueue<TSize>::clear()
+{
+    auto snap = snapshot();
+    destroyRange(snap.first);
+    destroyRange(snap.second);
+    queue_.clear();
+}
+
+template <std::size_t TSize>
+template <typename TRecord, typename EventLoopQueue<TSize>::RecordOps TOps, typename TArg>
+bool EventLoopQueue<TSize>::pushRecord(TArg&& arg)
+{
+    // The record is constructed only after the space for it is reserved,
+    // i.e. the argument is not moved from if there is no space.
+    typedef TRecord TaskType;
+    static_assert(std::alignment_of<TaskType>::value <= std::alignment_of<ArrayElemType>::value,
+        "Alignment of the handler must not exceed alignment of the record");
+
+    static const std::size_t requiredQueueSize = RecordSize<TaskType>::Value;
+
+    auto placePtr = getAllocPlace(requiredQueueSize);
+    if (placePtr == nullptr) {
+        return false;
+    }
+
+    auto allocGuard = embxx::util::makeScopeGuard(
+        [this]()
+        {
+            queue_.popBack(requiredQueueSize);
+        });
+
+    auto taskPtr = new (placePtr + 1) TaskType(std::forward<TArg>(arg));
+    static_cast<void>(taskPtr);
+    allocGuard.release();
+
+    new (placePtr) RecordOps(TOps);
+
+    GASSERT(!queue_.isEmpty());
+    GASSERT(requiredQueueSize <= queue_.size());
+    return true;
+}
+
+template <std::size_t TSize>
+template <typename TTask, bool TPinned, typename TTarget>
+std::size_t EventLoopQueue<TSize>::taskOps(
+    RecordOp op,
+    void* payload,
+    void* target)
+{
+    auto taskPtr = reinterpret_cast<TTask*>(payload);
+    switch (op) {
+    case RecordOp::Exec:
+        (*taskPtr)();
+        taskPtr->~TTask();
+        break;
+
+    case RecordOp::Destroy:
+        taskPtr->~TTask();
+        break;
+
+    case RecordOp::MoveTo:
+        GASSERT(target != nullptr);
+        if (TPinned || (!static_cast<TTarget*>(target)->push(std::move(*taskPtr)))) {
+            return 0;
+        }
+        taskPtr->~TTask();
+        break;
+
+    default:
+        break;
+    }
+    return RecordSize<TTask>::Value;
+}
+
+template <std::size_t TSize>
+template <typename TPoller>
+std::size_t EventLoopQueue<TSize>::pollerOps(
+    RecordOp op,
+    void* payload,
+    void* target)
+{
+    static_cast<void>(target);
+    auto pollerPtr = reinterpret_cast<TPoller*>(payload);
+    switch (op) {
+    case RecordOp::Poll:
+        if (!(*pollerPtr)()) {
+            return 0;
+        }
+        pollerPtr->~TPoller();
+        break;
+
+    case RecordOp::Destroy:
+        pollerPtr->~TPoller();
+        break;
+
+    case RecordOp::MoveTo:
+        return 0;
+
+    default:
+        GASSERT(op == RecordOp::GetSize);
+        break;
+    }
+    return RecordSize<TPoller>::Value;
+}
+
+template <std::size_t TSize>
+std::size_t EventLoopQueue<TSize>::holeOps(
+    RecordOp op,
+    void* payload,
+    void* target)
+{
+    static_cast<void>(target);
+    if (op == RecordOp::MoveTo) {
+        return 0;
+    }
+    return *reinterpret_cast<const std::size_t*>(payload);
+}
+
+template <std::size_t TSize>
+std::size_t EventLoopQueue<TSize>::invokeRecord(
+    QueueIter iter,
+    RecordOp op,
+    void* target)
+{
+    auto ops = *reinterpret_cast<RecordOps*>(iter);
+    if (ops == nullptr) {
+        if (op == RecordOp::MoveTo) {
+            return 0;
+        }
+        return static_cast<std::size_t>(std::distance(iter, queue_.invalidIter()));
+    }
+    return ops(op, iter + 1, target);
+}
+
+template <std::size_t TSize>
+bool EventLoopQueue<TSize>::isUnused(QueueIter iter)
+{
+    auto ops = *reinterpret_cast<RecordOps*>(iter);
+    return (ops == nullptr) || (ops == &EventLoopQueue::holeOps);
+}
+
+template <std::size_t TSize>
+void EventLoopQueue<TSize>::makeHole(QueueIter iter, std::size_t recordSize)
+{
+    // Records always have at least one element after the header to store
+    // the size of the hole.
+    GASSERT(1 < recordSize);
+    new (iter) RecordOps(&EventLoopQueue::holeOps);
+    new (iter + 1) std::size_t(recordSize);
+}
+
+template <std::size_t TSize>
+void EventLoopQueue<TSize>::pollRange(
+    const QueueRange& range,
+    std::size_t fromIdx,
+    std::size_t toIdx,
+    std::size_t& liveIdx,
+    std::size_t& budget,
+    std::size_t& nextIdx)
+{
+    auto iter = range.first;
+    while ((iter != range.second) && (liveIdx < toIdx) && (0 < budget)) {
+        auto recordSize = invokeRecord(iter, RecordOp::GetSize);
+        GASSERT(recordSize <= static_cast<std::size_t>(std::distance(iter, range.second)));
+        if (!isUnused(iter)) {
+            if (fromIdx <= liveIdx) {
+                nextIdx = liveIdx + 1;
+                --budget;
+                if (invokeRecord(iter, RecordOp::Poll) != 0) {
+                    makeHole(iter, recordSize);
+                }
+            }
+            ++liveIdx;
+        }
+        iter += recordSize;
+    }
+}
+
+template <std::size_t TSize>
+typename EventLoopQueue<TSize>::ArrayElemType*
+EventLoopQueue<TSize>::getAllocPlace(
+    std::size_t requiredQueueSize)
+{
+    if ((queue_.capacity() - queue_.size()) < requiredQueueSize) {
+        return nullptr;
+    }
+
+    // Empty queue is moved back to the beginning of the storage area
+    // on the next append, the whole area is contiguous.
+    auto curSize = queue_.size();
+    if ((0 < curSize) && queue_.isLinearised()) {
+        auto dist =
+            static_cast<std::size_t>(
+                std::distance(queue_.arrayTwo().second, queue_.invalidIter()));
+        if ((0 < dist) && (dist < requiredQueueSize)) {
+            if ((queue_.capacity() - curSize) < (dist + requiredQueueSize)) {
+                return nullptr;
+            }
+
+            // Mark the rest of the storage area as unused
+            queue_.resize(curSize + dist);
+            new (&queue_[curSize]) RecordOps(nullptr);
+            curSize += dist;
+        }
+    }
+
+    queue_.resize(curSize + requiredQueueSize);
+    return &queue_[curSize];
+}
+
+template <std::size_t TSize>
+void EventLoopQueue<TSize>::limitRange(QueueRange& range, std::size_t& budget)
+{
+    auto iter = range.first;
+    while ((iter != range.second) && (0 < budget)) {
+        iter += invokeRecord(iter, RecordOp::GetSize);
+        --budget;
+    }
+    range.second = iter;
+}
+
+template <std::size_t TSize>
+template <typename TStopFlag>
+std::size_t EventLoopQueue<TSize>::execRange(
+    const QueueRange& range,
+    std::size_t budget,
+    std::size_t& execCount,
+    const TStopFlag& stopped)
+{
+    std::size_t execSize = 0;
+    auto iter = range.first;
+    while (iter != range.second) {
+        if (((budget != 0) && (budget <= execCount)) ||
+            ((0 < execCount) && stopped)) {
+            break;
+        }
+
+        auto recordSize = invokeRecord(iter, RecordOp::Exec);
+        GASSERT(recordSize <= static_cast<std::size_t>(std::distance(iter, range.second)));
+        execSize += recordSize;
+        iter += recordSize;
+        ++execCount;
+    }
+    return execSize;
+}
+
+template <std::size_t TSize>
+void EventLoopQueue<TSize>::destroyRange(const QueueRange& range)
+{
+    auto iter = range.first;
+    while (iter != range.second) {
+        iter += invokeRecord(iter, RecordOp::Destroy);
+    }
+}
+
+// Idle pollers state of the event loop. Used as a base class, so the
+// disabled pollers (TPollSize is 0) don't occupy any space.
+template <std::size_t TPollSize>
+class EventLoopPollers
+{
+protected:
+    EventLoopPollers()
+      : pollBudget_(0),
+        pollBackoffLimit_(0),
+        activeBackoffLimit_(0),
+        pollStartIdx_(0)
+    {
+    }
+
+    bool hasPollers() const
+    {
+        return !pollQueue_.isEmpty();
+    }
+
+    template <typename TPoller>
+    bool pushPoller(TPoller&& poller)
+    {
+        return pollQueue_.pushPoller(std::forward<TPoller>(poller));
+    }
+
+    // Called and returns with the lock held
+    template <typename TLock>
+    void pollOnce(TLock& lock)
+    {
+        // Pollers are only added to the queue, and only the loop
+        // itself turns completed ones into holes.
+        auto pollSnapshot = pollQueue_.snapshot();
+        auto pollBudget = pollBudget_;
+        activeBackoffLimit_ = pollBackoffLimit_;
+        lock.unlock();
+
+        pollStartIdx_ = pollQueue_.poll(pollSnapshot, pollStartIdx_, pollBudget);
+
+        lock.lock();
+        pollQueue_.releaseHoles();
+        if (pollQueue_.isEmpty()) {
+            pollStartIdx_ = 0;
+        }
+    }
+
+    void setPollersBudget(std::size_t budget)
+    {
+        pollBudget_ = budget;
+    }
+
+    void setPollersBackoffLimit(std::size_t limit)
+    {
+        pollBackoffLimit_ = limit;
+    }
+
+    // Accessed by the pollers without the lock, snapshot of the limit
+    // taken by pollOnce().
+    std::size_t pollersBackoffLimit() const
+    {
+        return activeBackoffLimit_;
+    }
+
+    void clearPollers()
+    {
+        pollQueue_.clear();
+        pollStartIdx_ = 0;
+    }
+
+private:
+    EventLoopQueue<TPollSize> pollQueue_;
+    std::size_t pollBudget_;
+    std::size_t pollBackoffLimit_;
+    std::size_t activeBackoffLimit_;
+    std::size_t pollStartIdx_;
+};
+
+template <>
+class EventLoopPollers<0>
+{
+protected:
+    bool hasPollers() const
+    {
+        return false;
+    }
+
+    template <typename TLock>
+    void pollOnce(TLock& lock)
+    {
+        static_cast<void>(lock);
+    }
+
+    void setPollersBudget(std::size_t budget)
+    {
+        static_cast<void>(budget);
+    }
+
+    void setPollersBackoffLimit(std::size_t limit)
+    {
+        static_cast<void>(limit);
+    }
+
+    void clearPollers() {}
+};
+
+// Overflow spill area of the event loop. Used as a base class, so the
+// disabled spill area (TSpillSize is 0) doesn't occupy any space.
+template <std::size_t TSpillSize>
+class EventLoopSpill
+{
+protected:
+    bool isSpillEmpty() const
+    {
+        return spill_.isEmpty();
+    }
+
+    std::size_t spillAvailableBytes() const
+    {
+        return spill_.availableBytes();
+    }
+
+    std::size_t spillUsedBytes() const
+    {
+        return spill_.usedBytes();
+    }
+
+    template <typename TTarget, typename TRecord, typename TArg>
+    bool emplaceToSpill(TArg&& arg)
+    {
+        // The record that doesn't fit into the main queue would never be
+        // moved out of the spill area and would block all the handlers
+        // posted after it.
+        if (!TTarget::template canHold<TRecord>()) {
+            return false;
+        }
+
+        return spill_.template emplaceMovableTo<TTarget, TRecord>(std::forward<TArg>(arg));
+    }
+
+    template <typename TTarget>
+    void moveSpillTo(TTarget& queue)
+    {
+        while (spill_.moveFrontTo(queue)) {}
+    }
+
+    void clearSpill()
+    {
+        spill_.clear();
+    }
+
+private:
+    EventLoopQueue<TSpillSize> spill_;
+};
+
+template <>
+class EventLoopSpill<0>
+{
+protected:
+    bool isSpillEmpty() const
+    {
+        return true;
+    }
+
+    std::size_t spillAvailableBytes() const
+    {
+        return 0;
+    }
+
+    std::size_t spillUsedBytes() const
+    {
+        return 0;
+    }
+
+    template <typename TTarget, typename TRecord, typename TArg>
+    bool emplaceToSpill(TArg&& arg)
+    {
+        static_cast<void>(arg);
+        return false;
+    }
+
+    template <typename TTarget>
+    void moveSpillTo(TTarget& queue)
+    {
+        static_cast<void>(queue);
+    }
+
+    void clearSpill() {}
+};
+
+// State of the asynchronous capacity wait request. Used as a base class,
+// so the disabled request (TWaitHandler is void) doesn't occupy any space.
+template <typename TWaitHandler>
+class EventLoopCapacityWait
+{
+protected:
+    EventLoopCapacityWait()
+      : waitCapacity_(0),
+        waitAborted_(false)
+    {
+    }
+
+    template <typename TFunc>
+    void startCapacityWait(std::size_t capacity, TFunc&& func)
+    {
+        GASSERT(!waitHandler_);
+        waitHandler_ = std::forward<TFunc>(func);
+        waitCapacity_ = capacity;
+        waitAborted_ = false;
+    }
+
+    bool abortCapacityWait()
+    {
+        if (!waitHandler_) {
+            return false;
+        }
+
+        waitAborted_ = true;
+        return true;
+    }
+
+    // Called and returns with the lock held, the lock is released while
+    // the callback is executed.
+    template <typename TLock>
+    bool invokeCapacityWaiter(TLock& lock, std::size_t availableCapacity)
+    {
+        if ((!waitHandler_) ||
+            ((!waitAborted_) && (availableCapacity < waitCapacity_))) {
+            return false;
+        }
+
+        auto handler = std::move(waitHandler_);
+        waitHandler_ = nullptr;
+        embxx::error::ErrorStatus status(embxx::error::ErrorCode::Success);
+        if (waitAborted_) {
+            status = embxx::error::ErrorCode::Aborted;
+        }
+        waitAborted_ = false;
+
+        lock.unlock();
+        auto lockGuard = embxx::util::makeScopeGuard(
+            [&lock]()
+            {
+                lock.lock();
+            });
+
+        handler(status);
+        return true;
+    }
+
+    void clearCapacityWait()
+    {
+        waitHandler_ = nullptr;
+        waitAborted_ = false;
+    }
+
+private:
+    TWaitHandler waitHandler_;
+    std::size_t waitCapacity_;
+    bool waitAborted_;
+};
+
+template <>
+class EventLoopCapacityWait<void>
+{
+protected:
+    bool abortCapacityWait()
+    {
+        return false;
+    }
+
+    template <typename TLock>
+    bool invokeCapacityWaiter(TLock& lock, std::size_t availableCapacity)
+    {
+        static_cast<void>(lock);
+        static_cast<void>(availableCapacity);
+        return false;
+    }
+
+    void clearCapacityWait() {}
+};
+
+/// @endcond
+
+}  // namespace details
+
 /// @addtogroup util
 /// @{
 
@@ -58,12 +982,45 @@ namespace util
 ///
 ///         Both of these functions are called after call to lock() member
 ///         function of the TLock object.
+/// @tparam TStats Statistics policy. The default embxx::util::EventLoopNoStats
+///         doesn't collect anything and has no run-time overhead. Use
+///         embxx::util::EventLoopStats to collect queue usage and
+///         handler timing information.
+/// @tparam TPollSize Size in bytes to be allocated as data member for
+///         registration of idle pollers created by busyWait(). The default
+///         value of 0 disables the pollers and busyWait() falls back to
+///         re-posting itself to the handlers queue. The disabled pollers
+///         don't occupy any space in the event loop object.
+/// @tparam TSpillSize Size in bytes to be allocated as data member for
+///         the overflow spill area. The handlers that don't fit into the
+///         main queue are stored there and moved to the main queue
+///         in order of their posting when space becomes available.
+///         The default value of 0 disables the spill area, which doesn't
+///         occupy any space in the event loop object then.
+/// @tparam TWaitHandler Callback functor class to be called when requested
+///         capacity becomes available. Must be either
+///         std::function or embxx::util::StaticFunction and have
+///         "void (const embxx::error::ErrorStatus&)" signature. It is used to
+///         store callback handler provided in asyncWaitCapacity() request.
+///         The default value void disables asyncWaitCapacity(), the
+///         disabled request doesn't occupy any space in the event loop
+///         object.
 /// @headerfile embxx/util/EventLoop.h
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-class EventLoop
+          typename TCond,
+          typename TStats = EventLoopNoStats,
+          std::size_t TPollSize = 0,
+          std::size_t TSpillSize = 0,
+          typename TWaitHandler = void>
+class EventLoop : private details::EventLoopPollers<TPollSize>,
+                  private details::EventLoopSpill<TSpillSize>,
+                  private details::EventLoopCapacityWait<TWaitHandler>
 {
+    typedef details::EventLoopPollers<TPollSize> Pollers;
+    typedef details::EventLoopSpill<TSpillSize> Spill;
+    typedef details::EventLoopCapacityWait<TWaitHandler> CapacityWait;
+
 public:
     /// @brief Type of the lock
     typedef TLock LockType;
@@ -71,6 +1028,12 @@ public:
     /// @brief Type of the condition variable
     typedef TCond CondType;
 
+    /// @brief Type of the capacity wait handler
+    typedef TWaitHandler WaitHandler;
+
+    /// @brief Type of the statistics policy
+    typedef TStats StatsType;
+
     /// @brief Constructor.
     EventLoop();
 
@@ -83,6 +1046,9 @@ public:
     /// @brief Get reference to the condition variable
     CondType& getCond();
 
+    /// @brief Get reference to the statistics policy object.
+    StatsType& getStats();
+
     /// @brief Post new handler for execution.
     /// @details Acquires regular context lock. The task is added to the
     ///          execution queue. If the execution queue is empty before the
@@ -109,6 +1075,69 @@ public:
     template <typename TTask>
     bool postInterruptCtx(TTask&& task);
 
+    /// @brief Post new handler for execution and report remaining capacity.
+    /// @details Same as post(task), but also reports the capacity that
+    ///          remains available after the post attempt.
+    /// @param[in] task R-value reference to new handler functor.
+    /// @param[out] capacity Remaining capacity in bytes, see
+    ///             availableCapacity().
+    /// @return true in case the handler was successfully posted, false if
+    ///         there is not enough space in the execution queue.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: Basic
+    template <typename TTask>
+    bool post(TTask&& task, std::size_t& capacity);
+
+    /// @brief Post new handler for execution from interrupt context and
+    ///        report remaining capacity.
+    /// @details Same as postInterruptCtx(task), but also reports the
+    ///          capacity that remains available after the post attempt.
+    /// @param[in] task R-value reference to new handler functor.
+    /// @param[out] capacity Remaining capacity in bytes, see
+    ///             availableCapacity().
+    /// @return true in case the handler was successfully posted, false if
+    ///         there is not enough space in the execution queue.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: Basic
+    template <typename TTask>
+    bool postInterruptCtx(TTask&& task, std::size_t& capacity);
+
+    /// @brief Get capacity available for new handlers.
+    /// @details Reports number of unused bytes in the queue of handlers
+    ///          and in the spill area. Every posted handler occupies
+    ///          its size rounded up to the size of the pointer plus two
+    ///          pointers of bookkeeping information. The handler may
+    ///          also fail to fit due to wrap around of the queue even if its
+    ///          size is less than reported capacity.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    std::size_t availableCapacity();
+
+    /// @brief Perform asynchronous wait until requested capacity becomes
+    ///        available.
+    /// @details The function records the callback object and returns
+    ///          immediately. The callback will be called by run() in the
+    ///          context of the event loop (without being posted to the
+    ///          queue of handlers) when availableCapacity() reports at least
+    ///          the requested capacity.
+    /// @param capacity Requested capacity in bytes.
+    /// @param func Callback functor object,
+    ///        must have "void (const embxx::error::ErrorStatus&)" signature.
+    /// @pre All the previous asynchronous wait requests are complete (their
+    ///      callback has been executed).
+    /// @pre @code capacity <= (TSize + TSpillSize) @endcode
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: Basic
+    template <typename TFunc>
+    void asyncWaitCapacity(std::size_t capacity, TFunc&& func);
+
+    /// @brief Cancel pending asynchronous capacity wait request.
+    /// @details The callback of the pending request will be called with
+    ///          embxx::error::ErrorCode::Aborted status.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    void cancelWaitCapacity();
+
     /// @brief Event loop execution function.
     /// @details The function keeps executing posted handlers until none
     ///          are left. When execution queue becomes empty the wait(...)
@@ -119,7 +1148,9 @@ public:
     ///          the event loop. This function never exits unless stop() was
     ///          called to terminate the execution. After stopping the main
     ///          loop, use reset() member function to enable the loop to be
-    ///          executed again.
+    ///          executed again. The number of handlers executed between
+    ///          two acquisitions of the lock is controlled by
+    ///          setDrainBudget().
     /// @note Thread safety: Unsafe
     /// @note Exception guarantee: Basic
     void run();
@@ -141,7 +1172,14 @@ public:
 
     /// @brief Perform busy wait.
     /// @details Executes busy wait while allowing other event handlers posted
-    ///          by interrupt handlers being processed.
+    ///          by interrupt handlers being processed. If the pollers area
+    ///          is allocated (TPollSize is not 0), the predicate and the
+    ///          function are stored once as an idle poller. The pollers are
+    ///          evaluated by run() only when there are no pending handlers,
+    ///          and the "wait complete" function is posted when the
+    ///          predicate returns true. Otherwise the busy wait is
+    ///          implemented by re-posting itself to the handlers queue
+    ///          after every failed check of the predicate.
     /// @tparam TPred Predicate class type, must define
     ///         @code bool operator()(); @endcode
     ///         that return true in case busy wait must be terminated.
@@ -150,44 +1188,55 @@ public:
     ///         @code void operator()(); @endcode
     /// @param pred Any type of reference to predicate object
     /// @param func Any type of reference to "wait complete" function.
-    /// @pre The event loop must have enough space to repost the call to
-    ///      busyWait. Note that there is no way to notify the caller if post
-    ///      operation fails. In debug compilation mode there will be
-    ///      an assertion failure in case call to post() returned false, in
+    /// @pre The event loop must have enough space to register the poller
+    ///      (or repost the call to busyWait when pollers are disabled).
+    ///      Note that there is no way to notify the caller if the
+    ///      registration fails. In debug compilation mode there will be
+    ///      an assertion failure in case of such failure, in
     ///      release compilation mode the failure will be silent.
     template <typename TPred, typename TFunc>
     void busyWait(TPred&& pred, TFunc&& func);
 
-private:
-
-    /// @cond DOCUMENT_EVENT_LOOP_TASK
-    class Task
-    {
-    public:
-        virtual ~Task();
-        virtual std::size_t getSize() const;
-        virtual void exec();
-    };
-
-    template <typename TTask>
-    class TaskBound : public Task
-    {
-
-    public:
-        explicit TaskBound(const TTask& task);
-        explicit TaskBound(TTask&& task);
-        virtual ~TaskBound();
-
-        virtual std::size_t getSize() const;
-        virtual void exec();
-
-        static const std::size_t Size =
-            ((sizeof(TaskBound<typename std::decay<TTask>::type>) - 1) / sizeof(Task)) + 1;
+    /// @brief Set maximal number of pollers evaluated per loop cycle.
+    /// @details When there are no pending handlers, run() evaluates up to
+    ///          "budget" registered pollers and then checks the handlers
+    ///          queue again. The evaluation continues from the poller that
+    ///          follows the last evaluated one. The default value 0 means
+    ///          no limit, i.e. all the registered pollers are evaluated.
+    /// @param budget Maximal number of pollers evaluated per cycle.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    void setPollBudget(std::size_t budget);
+
+    /// @brief Set upper limit of the exponential poll back-off.
+    /// @details Every failed check of the predicate doubles the number of
+    ///          subsequent loop cycles in which the poller is skipped,
+    ///          up to the provided limit. The default value 0 disables the
+    ///          back-off, i.e. the predicate is checked every cycle.
+    /// @param limit Maximal number of cycles to skip between checks.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    void setPollBackoffLimit(std::size_t limit);
+
+    /// @brief Set maximal number of handlers executed per single drain.
+    /// @details The run() function takes a snapshot of the queue of pending
+    ///          handlers under the lock, executes up to "budget" of them
+    ///          without acquiring the lock in between, and then releases the
+    ///          storage of all the executed handlers in a single lock round
+    ///          trip. Only after that the "stopped" state and the queue are
+    ///          checked again. Handlers posted during the drain are executed
+    ///          in the following drain. The default budget is 1, which
+    ///          results in acquiring the lock after every handler. Value 0
+    ///          means no limit, i.e. all the handlers present in the queue
+    ///          at the beginning of the drain get executed.
+    /// @param budget Maximal number of handlers to execute per drain.
+    /// @note The call to stop() is still honoured after the currently
+    ///       executed handler is complete, the rest of the drain is skipped.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    void setDrainBudget(std::size_t budget);
 
-    private:
-        TTask task_;
-    };
-    /// @endcond
+private:
 
     /// @cond DOCUMENT_INTERRUPT_LOCK_WRAPPER
     template <typename TInternalLock>
@@ -209,24 +1258,49 @@ private:
     };
     /// @endcond
 
-    typedef typename
-        std::aligned_storage<
-            sizeof(Task),
-            std::alignment_of<Task>::value
-        >::type ArrayElemType;
+    template <typename TPred, typename TFunc>
+    class PollTask
+    {
+    public:
+        template <typename TPredParam, typename TFuncParam>
+        PollTask(EventLoop& el, TPredParam&& pred, TFuncParam&& func)
+          : el_(el),
+            pred_(std::forward<TPredParam>(pred)),
+            func_(std::forward<TFuncParam>(func)),
+            skip_(0),
+            backoff_(0)
+        {
+        }
+
+        bool operator()();
+
+    private:
+        EventLoop& el_;
+        TPred pred_;
+        TFunc func_;
+        std::size_t skip_;
+        std::size_t backoff_;
+    };
+
+    typedef details::EventLoopQueue<TSize> EventQueue;
 
-    static const std::size_t ArraySize = TSize / sizeof(Task);
-    typedef embxx::container::StaticQueue<ArrayElemType, ArraySize> EventQueue;
+    typedef std::integral_constant<bool, (0 < TPollSize)> PollersEnabled;
 
     template <typename TTask>
     bool postNoLock(TTask&& task);
 
-    ArrayElemType* getAllocPlace(std::size_t requiredQueueSize);
+    template <typename TPred, typename TFunc>
+    void busyWaitInternal(TPred&& pred, TFunc&& func, std::true_type);
+
+    template <typename TPred, typename TFunc>
+    void busyWaitInternal(TPred&& pred, TFunc&& func, std::false_type);
 
     EventQueue queue_;
     LockType lock_;
     CondType cond_;
+    StatsType stats_;
     volatile bool stopped_;
+    std::size_t drainBudget_;
 };
 
 /// @}
@@ -234,36 +1308,66 @@ private:
 // Implementation
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-EventLoop<TSize, TLock, TCond>::EventLoop()
-    : stopped_(false)
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::EventLoop()
+    : stopped_(false),
+      drainBudget_(1)
 {
     GASSERT(queue_.isEmpty());
 }
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-typename EventLoop<TSize, TLock, TCond>::LockType&
-EventLoop<TSize, TLock, TCond>::getLock()
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+typename EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::LockType&
+EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::getLock()
 {
     return lock_;
 }
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-typename EventLoop<TSize, TLock, TCond>::CondType&
-EventLoop<TSize, TLock, TCond>::getCond()
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+typename EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::CondType&
+EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::getCond()
 {
     return cond_;
 }
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+typename EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::StatsType&
+EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::getStats()
+{
+    return stats_;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
 template <typename TTask>
-bool EventLoop<TSize, TLock, TCond>::post(TTask&& task)
+bool EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::post(TTask&& task)
 {
     std::lock_guard<LockType> guard(lock_);
     return postNoLock(std::forward<TTask>(task));
@@ -271,9 +1375,13 @@ bool EventLoop<TSize, TLock, TCond>::post(TTask&& task)
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
 template <typename TTask>
-bool EventLoop<TSize, TLock, TCond>::postInterruptCtx(
+bool EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::postInterruptCtx(
     TTask&& task)
 {
     InterruptLockWrapper<LockType> wrapperLock(lock_);
@@ -281,11 +1389,102 @@ bool EventLoop<TSize, TLock, TCond>::postInterruptCtx(
     return postNoLock(std::forward<TTask>(task));
 }
 
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+template <typename TTask>
+bool EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::post(
+    TTask&& task,
+    std::size_t& capacity)
+{
+    std::lock_guard<LockType> guard(lock_);
+    bool result = postNoLock(std::forward<TTask>(task));
+    capacity = queue_.availableBytes() + Spill::spillAvailableBytes();
+    return result;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+template <typename TTask>
+bool EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::postInterruptCtx(
+    TTask&& task,
+    std::size_t& capacity)
+{
+    InterruptLockWrapper<LockType> wrapperLock(lock_);
+    std::lock_guard<decltype(wrapperLock)> guard(wrapperLock);
+    bool result = postNoLock(std::forward<TTask>(task));
+    capacity = queue_.availableBytes() + Spill::spillAvailableBytes();
+    return result;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+std::size_t EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::availableCapacity()
+{
+    std::lock_guard<LockType> guard(lock_);
+    return queue_.availableBytes() + Spill::spillAvailableBytes();
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+template <typename TFunc>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::asyncWaitCapacity(
+    std::size_t capacity,
+    TFunc&& func)
+{
+    static_assert(!std::is_void<TWaitHandler>::value,
+        "The capacity wait is disabled, provide TWaitHandler template parameter");
+    GASSERT(capacity <= (TSize + TSpillSize));
+    std::lock_guard<LockType> guard(lock_);
+    CapacityWait::startCapacityWait(capacity, std::forward<TFunc>(func));
+    if (capacity <= (queue_.availableBytes() + Spill::spillAvailableBytes())) {
+        cond_.notify();
+    }
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::cancelWaitCapacity()
+{
+    std::lock_guard<LockType> guard(lock_);
+    if (CapacityWait::abortCapacityWait()) {
+        cond_.notify();
+    }
+}
+
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-void EventLoop<TSize, TLock, TCond>::run()
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::run()
 {
     while (true) {
         lock_.lock();
@@ -296,24 +1495,40 @@ void EventLoop<TSize, TLock, TCond>::run()
             });
 
         while (!stopped_) {
+            Spill::moveSpillTo(queue_);
+            if (CapacityWait::invokeCapacityWaiter(
+                    lock_,
+                    queue_.availableBytes() + Spill::spillAvailableBytes())) {
+                continue;
+            }
+
             volatile bool empty = queue_.isEmpty();
             if (empty) {
                 break;
             }
 
-            auto taskPtr = reinterpret_cast<Task*>(&queue_.front());
-            auto sizeToRemove = taskPtr->getSize();
+            // Producers only append to the queue, the snapshot of currently
+            // pending handlers stays valid while the lock is released.
+            auto snapshot = queue_.snapshot();
+            auto budget = drainBudget_;
             lock_.unlock();
-            taskPtr->exec();
-            taskPtr->~Task();
+
+            std::size_t execCount = 0;
+            auto sizeToRemove = queue_.exec(snapshot, budget, execCount, stopped_);
+
             lock_.lock();
-            queue_.popFront(sizeToRemove);
+            queue_.release(sizeToRemove);
         }
 
         if (stopped_) {
             break;
         }
 
+        if (Pollers::hasPollers()) {
+            Pollers::pollOnce(lock_);
+            continue;
+        }
+
         // Still locked prior to wait
         cond_.wait(lock_);
     }
@@ -321,8 +1536,12 @@ void EventLoop<TSize, TLock, TCond>::run()
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-void EventLoop<TSize, TLock, TCond>::stop()
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::stop()
 {
     std::lock_guard<LockType> guard(lock_);
     stopped_ = true;
@@ -331,130 +1550,206 @@ void EventLoop<TSize, TLock, TCond>::stop()
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-void EventLoop<TSize, TLock, TCond>::reset()
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::reset()
 {
     std::lock_guard<LockType> guard(lock_);
     stopped_ = false;
     queue_.clear();
+    Pollers::clearPollers();
+    Spill::clearSpill();
+    CapacityWait::clearCapacityWait();
 }
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
 template <typename TPred, typename TFunc>
-void EventLoop<TSize, TLock, TCond>::busyWait(TPred&& pred, TFunc&& func)
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::busyWait(TPred&& pred, TFunc&& func)
 {
-    if (pred()) {
-        bool result = post(std::forward<TFunc>(func));
-        GASSERT(result);
-        static_cast<void>(result);
-        return;
-    }
-
-    bool result = post(
-        [this, pred, func]()
-        {
-            busyWait(std::move(pred), std::move(func));
-        });
-    GASSERT(result);
-    static_cast<void>(result);
+    busyWaitInternal(
+        std::forward<TPred>(pred),
+        std::forward<TFunc>(func),
+        PollersEnabled());
 }
 
-/// @cond DOCUMENT_EVENT_LOOP_TASK
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-EventLoop<TSize, TLock, TCond>::Task::~Task()
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::setDrainBudget(std::size_t budget)
 {
+    std::lock_guard<LockType> guard(lock_);
+    drainBudget_ = budget;
 }
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-std::size_t EventLoop<TSize, TLock, TCond>::Task::getSize() const
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::setPollBudget(std::size_t budget)
 {
-    return 1;
+    std::lock_guard<LockType> guard(lock_);
+    Pollers::setPollersBudget(budget);
 }
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-void EventLoop<TSize, TLock, TCond>::Task::exec()
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::setPollBackoffLimit(
+    std::size_t limit)
 {
+    std::lock_guard<LockType> guard(lock_);
+    Pollers::setPollersBackoffLimit(limit);
 }
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-template <typename TTask>
-EventLoop<TSize, TLock, TCond>::TaskBound<TTask>::TaskBound(const TTask& task)
-    : task_(task)
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+template <typename TPred, typename TFunc>
+bool EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::PollTask<TPred, TFunc>::operator()()
 {
-}
+    if (0 < skip_) {
+        --skip_;
+        return false;
+    }
 
-template <std::size_t TSize,
-          typename TLock,
-          typename TCond>
-template <typename TTask>
-EventLoop<TSize, TLock, TCond>::TaskBound<TTask>::TaskBound(TTask&& task)
-    : task_(std::move(task))
-{
-}
+    if (!pred_()) {
+        auto limit = el_.pollersBackoffLimit();
+        backoff_ = std::min(std::max(backoff_ * 2, std::size_t(1)), limit);
+        skip_ = backoff_;
+        return false;
+    }
 
-template <std::size_t TSize,
-          typename TLock,
-          typename TCond>
-template <typename TTask>
-EventLoop<TSize, TLock, TCond>::TaskBound<TTask>::~TaskBound()
-{
+    // Copy of the function is posted, the poller stays registered and
+    // retries next cycle if there is no space in the handlers queue.
+    return el_.post(func_);
 }
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-template <typename TTask>
-std::size_t EventLoop<TSize, TLock, TCond>::TaskBound<TTask>::getSize() const
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+template <typename TPred, typename TFunc>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::busyWaitInternal(
+    TPred&& pred,
+    TFunc&& func,
+    std::true_type)
 {
-    return Size;
+    if (pred()) {
+        bool result = post(std::forward<TFunc>(func));
+        GASSERT(result);
+        static_cast<void>(result);
+        return;
+    }
+
+    typedef PollTask<
+        typename std::decay<TPred>::type,
+        typename std::decay<TFunc>::type
+    > Poller;
+
+    std::lock_guard<LockType> guard(lock_);
+    bool wasIdle = queue_.isEmpty() && (!Pollers::hasPollers());
+    bool result = Pollers::pushPoller(
+        Poller(*this, std::forward<TPred>(pred), std::forward<TFunc>(func)));
+    GASSERT(result);
+    static_cast<void>(result);
+    if (result && wasIdle) {
+        cond_.notify();
+    }
 }
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
-template <typename TTask>
-void EventLoop<TSize, TLock, TCond>::TaskBound<TTask>::exec()
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
+template <typename TPred, typename TFunc>
+void EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::busyWaitInternal(
+    TPred&& pred,
+    TFunc&& func,
+    std::false_type)
 {
-    task_();
-}
+    if (pred()) {
+        bool result = post(std::forward<TFunc>(func));
+        GASSERT(result);
+        static_cast<void>(result);
+        return;
+    }
 
-/// @endcond
+    bool result = post(
+        [this, pred, func]()
+        {
+            busyWait(std::move(pred), std::move(func));
+        });
+    GASSERT(result);
+    static_cast<void>(result);
+}
 
 template <std::size_t TSize,
           typename TLock,
-          typename TCond>
+          typename TCond,
+          typename TStats,
+          std::size_t TPollSize,
+          std::size_t TSpillSize,
+          typename TWaitHandler>
 template <typename TTask>
-bool EventLoop<TSize, TLock, TCond>::postNoLock(TTask&& task)
+bool EventLoop<TSize, TLock, TCond, TStats, TPollSize, TSpillSize, TWaitHandler>::postNoLock(TTask&& task)
 {
-    typedef TaskBound<typename std::decay<TTask>::type> TaskBoundType;
-    static_assert(std::alignment_of<Task>::value == std::alignment_of<TaskBoundType>::value,
-        "Alignment of TaskBound must be same as alignment of Task");
-
-    static const std::size_t requiredQueueSize = TaskBoundType::Size;
+    typedef typename StatsType::template WrappedTask<TTask>::Type RecordType;
 
     bool wasEmpty = queue_.isEmpty();
+    auto&& wrappedTask = stats_.wrap(std::forward<TTask>(task));
+    typedef decltype(wrappedTask) WrappedTaskType;
+
+    // Once there are handlers in the spill area, the new ones are also
+    // placed there to preserve the order of execution. The record is
+    // constructed from the wrapped handler only after the space is
+    // reserved, i.e. the handler is not moved from if there is no space
+    // in the queue.
+    bool pushed =
+        Spill::isSpillEmpty() &&
+        queue_.template emplace<RecordType>(std::forward<WrappedTaskType>(wrappedTask));
+
+    if (!pushed) {
+        pushed =
+            Spill::template emplaceToSpill<EventQueue, RecordType>(
+                std::forward<WrappedTaskType>(wrappedTask));
+    }
 
-    auto placePtr = getAllocPlace(requiredQueueSize);
-    if (placePtr == nullptr) {
+    if (!pushed) {
+        stats_.postFailed();
         return false;
     }
 
-    auto taskPtr = new (placePtr) TaskBoundType(std::forward<TTask>(task));
-    static_cast<void>(taskPtr);
-
-    GASSERT(!queue_.isEmpty());
-    GASSERT(requiredQueueSize <= queue_.size());
-
+    stats_.posted(queue_.usedBytes() + Spill::spillUsedBytes());
     if (wasEmpty) {
         cond_.notify();
     }
@@ -462,39 +1757,6 @@ bool EventLoop<TSize, TLock, TCond>::postNoLock(TTask&& task)
     return true;
 }
 
-template <std::size_t TSize,
-          typename TLock,
-          typename TCond>
-typename EventLoop<TSize, TLock, TCond>::ArrayElemType*
-EventLoop<TSize, TLock, TCond>::getAllocPlace(
-    std::size_t requiredQueueSize)
-{
-    auto invalidIter = queue_.invalidIter();
-    while (true)
-    {
-        if ((queue_.capacity() - queue_.size()) < requiredQueueSize) {
-            return nullptr;
-        }
-
-        auto curSize = queue_.size();
-        if (queue_.isLinearised()) {
-            auto dist =
-                static_cast<std::size_t>(
-                    std::distance(queue_.arrayTwo().second, invalidIter));
-            if ((0 < dist) && (dist < requiredQueueSize)) {
-                queue_.resize(curSize + 1);
-                auto placePtr = static_cast<void*>(&queue_.back());
-                auto taskPtr = new (placePtr) Task();
-                static_cast<void>(taskPtr);
-                continue;
-            }
-        }
-
-        queue_.resize(curSize + requiredQueueSize);
-        return &queue_[curSize];
-    }
-}
-
 }  // namespace util
 
 }  // namespace embxx
@@ -0,0 +1,574 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/EventLoopPool.h
+/// Contains EventLoopPool class definition.
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <array>
+#include <atomic>
+
+#include "embxx/util/EventLoop.h"
+#include "embxx/util/Assert.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+/// @addtogroup util
+/// @{
+
+/// @brief Pool of event loop shards executed by multiple worker threads.
+/// @details Contains TShardCount independent queues of handlers (shards),
+///          each protected by its own lock and having its own condition
+///          variable. Every shard is executed by a single worker thread
+///          that calls runWorker() with the index of the shard. The pool
+///          doesn't create any threads by itself, creation of the worker
+///          threads and pinning them to specific cores is a
+///          responsibility of the application.
+///
+///          The handlers are constructed "in place" inside the shard
+///          queues, no dynamic memory allocation is performed. When worker
+///          has no more handlers in its own shard, it tries to "steal"
+///          a pending handler from other shards, by moving it into its own
+///          queue. The handlers that are currently executed or claimed for
+///          execution by their owner are never stolen.
+/// @tparam TShardSize Size in bytes of the queue of every shard.
+/// @tparam TLock "Lockable" class, same as for embxx::util::EventLoop.
+///         Every shard has its own lock object.
+/// @tparam TCond Wait condition variable class, same as for
+///         embxx::util::EventLoop. Every shard has its own condition
+///         variable object.
+/// @tparam TShardCount Number of shards (worker threads).
+/// @headerfile embxx/util/EventLoopPool.h
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+class EventLoopPool
+{
+    static_assert(0 < TShardCount, "At least one shard is required");
+
+public:
+    /// @brief Type of the lock
+    typedef TLock LockType;
+
+    /// @brief Type of the condition variable
+    typedef TCond CondType;
+
+    /// @brief Number of shards.
+    static const std::size_t ShardCount = TShardCount;
+
+    /// @brief Constructor.
+    EventLoopPool();
+
+    /// @brief Destructor
+    ~EventLoopPool() = default;
+
+    /// @brief Get reference to the lock of specific shard.
+    /// @pre idx < ShardCount
+    LockType& getLock(std::size_t idx);
+
+    /// @brief Get reference to the condition variable of specific shard.
+    /// @pre idx < ShardCount
+    CondType& getCond(std::size_t idx);
+
+    /// @brief Post new handler for execution.
+    /// @details The shard is chosen in round-robin manner. The posted
+    ///          handler may be stolen by other idle worker.
+    /// @param[in] task R-value reference to new handler functor.
+    /// @return true in case the handler was successfully posted, false if
+    ///         there is not enough space in the queue of the chosen shard.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: Basic
+    template <typename TTask>
+    bool post(TTask&& task);
+
+    /// @brief Post new handler for execution using affinity key.
+    /// @details The handler is posted into the shard with index
+    ///          (key % ShardCount). The affinity is just a placement hint,
+    ///          the handler may still be stolen by other idle worker, i.e.
+    ///          handlers posted with the same key may be executed
+    ///          concurrently and not in the order of posting. Use
+    ///          postPinned() to guarantee serialised execution.
+    /// @param[in] key Affinity key.
+    /// @param[in] task R-value reference to new handler functor.
+    /// @return true in case the handler was successfully posted, false if
+    ///         there is not enough space in the queue of the chosen shard.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: Basic
+    template <typename TTask>
+    bool post(std::size_t key, TTask&& task);
+
+    /// @brief Post new handler that cannot be stolen.
+    /// @details The handler is posted into the shard with index
+    ///          (key % ShardCount) and is always executed by the worker of
+    ///          this shard. All the handlers pinned to the same shard are
+    ///          executed in the order of their posting.
+    /// @param[in] key Affinity key.
+    /// @param[in] task R-value reference to new handler functor.
+    /// @return true in case the handler was successfully posted, false if
+    ///         there is not enough space in the queue of the chosen shard.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: Basic
+    template <typename TTask>
+    bool postPinned(std::size_t key, TTask&& task);
+
+    /// @brief Post new handler for execution from interrupt context.
+    /// @details Same as post(task), but acquires interrupt context lock.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: Basic
+    template <typename TTask>
+    bool postInterruptCtx(TTask&& task);
+
+    /// @brief Post new handler for execution using affinity key from
+    ///        interrupt context.
+    /// @details Same as post(key, task), but acquires interrupt context lock.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: Basic
+    template <typename TTask>
+    bool postInterruptCtx(std::size_t key, TTask&& task);
+
+    /// @brief Worker execution function.
+    /// @details Must be called by the worker thread dedicated to the
+    ///          specified shard. Keeps executing handlers of the shard,
+    ///          when the shard becomes empty, tries to steal a handler
+    ///          from other shards. If there is nothing to steal, performs
+    ///          blocking wait on the condition variable of the shard. The
+    ///          idle worker is woken up when a new handler is posted into
+    ///          its shard or into other non-empty shard (to steal it). This
+    ///          function exits only after stop() is called.
+    /// @param idx Index of the shard.
+    /// @pre idx < ShardCount
+    /// @pre There is only one thread executing any given shard.
+    /// @note Thread safety: Safe for different shard indices.
+    /// @note Exception guarantee: Basic
+    void runWorker(std::size_t idx);
+
+    /// @brief Stop execution of all the workers.
+    /// @details Every worker stops after the handler it currently
+    ///          executes is complete.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    void stop();
+
+    /// @brief Reset the state of the pool.
+    /// @details Clears the queues of all the shards and resets the "stopped"
+    ///          flag to allow new execution of the workers.
+    /// @pre None of the workers is running.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: Basic
+    void reset();
+
+    /// @brief Set maximal number of handlers claimed by the worker per
+    ///        single drain of its shard.
+    /// @details Same as embxx::util::EventLoop::setDrainBudget(), but the
+    ///          handlers claimed for execution cannot be stolen. The default
+    ///          value is 1, value 0 means that all the pending handlers of
+    ///          the shard are claimed.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    void setDrainBudget(std::size_t budget);
+
+private:
+
+    /// @cond DOCUMENT_INTERRUPT_LOCK_WRAPPER
+    template <typename TInternalLock>
+    class InterruptLockWrapper
+    {
+    public:
+        InterruptLockWrapper(TInternalLock& intLock) : lock_(intLock) {}
+        void lock()
+        {
+            lock_.lockInterruptCtx();
+        }
+
+        void unlock()
+        {
+            lock_.unlockInterruptCtx();
+        }
+    private:
+        TInternalLock& lock_;
+    };
+    /// @endcond
+
+    typedef details::EventLoopQueue<TShardSize> ShardQueue;
+
+    struct Shard
+    {
+        Shard() : busySize_(0), idle_(false) {}
+
+        ShardQueue queue_;
+        LockType lock_;
+        CondType cond_;
+        std::size_t busySize_;
+        bool idle_;
+    };
+
+    typedef std::array<Shard, TShardCount> Shards;
+
+    template <typename TTask>
+    bool postToShard(std::size_t idx, bool pinned, TTask&& task);
+
+    template <typename TTask>
+    bool postToShardInterruptCtx(std::size_t idx, TTask&& task);
+
+    template <typename TTask>
+    bool postNoLock(Shard& shard, bool pinned, TTask&& task, bool& wakeIdle);
+
+    bool execShard(std::size_t idx);
+
+    bool steal(std::size_t idx);
+
+    void wakeIdleWorker(std::size_t busyIdx);
+
+    std::size_t nextShardIdx();
+
+    Shards shards_;
+    std::atomic<bool> stopped_;
+    std::atomic<std::size_t> idleCount_;
+    std::atomic<std::size_t> nextShard_;
+    std::atomic<std::size_t> drainBudget_;
+};
+
+/// @}
+
+// Implementation
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+EventLoopPool<TShardSize, TLock, TCond, TShardCount>::EventLoopPool()
+    : stopped_(false),
+      idleCount_(0),
+      nextShard_(0),
+      drainBudget_(1)
+{
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+typename EventLoopPool<TShardSize, TLock, TCond, TShardCount>::LockType&
+EventLoopPool<TShardSize, TLock, TCond, TShardCount>::getLock(std::size_t idx)
+{
+    GASSERT(idx < TShardCount);
+    return shards_[idx].lock_;
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+typename EventLoopPool<TShardSize, TLock, TCond, TShardCount>::CondType&
+EventLoopPool<TShardSize, TLock, TCond, TShardCount>::getCond(std::size_t idx)
+{
+    GASSERT(idx < TShardCount);
+    return shards_[idx].cond_;
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+template <typename TTask>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::post(TTask&& task)
+{
+    return postToShard(nextShardIdx(), false, std::forward<TTask>(task));
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+template <typename TTask>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::post(
+    std::size_t key,
+    TTask&& task)
+{
+    return postToShard(key % TShardCount, false, std::forward<TTask>(task));
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+template <typename TTask>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::postPinned(
+    std::size_t key,
+    TTask&& task)
+{
+    return postToShard(key % TShardCount, true, std::forward<TTask>(task));
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+template <typename TTask>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::postInterruptCtx(
+    TTask&& task)
+{
+    return postToShardInterruptCtx(nextShardIdx(), std::forward<TTask>(task));
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+template <typename TTask>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::postInterruptCtx(
+    std::size_t key,
+    TTask&& task)
+{
+    return postToShardInterruptCtx(key % TShardCount, std::forward<TTask>(task));
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+void EventLoopPool<TShardSize, TLock, TCond, TShardCount>::runWorker(
+    std::size_t idx)
+{
+    GASSERT(idx < TShardCount);
+    auto& shard = shards_[idx];
+    while (true) {
+        if (execShard(idx)) {
+            continue;
+        }
+
+        if (stopped_) {
+            break;
+        }
+
+        if (steal(idx)) {
+            continue;
+        }
+
+        std::lock_guard<LockType> guard(shard.lock_);
+        if ((!shard.queue_.isEmpty()) || stopped_) {
+            continue;
+        }
+
+        shard.idle_ = true;
+        ++idleCount_;
+        shard.cond_.wait(shard.lock_);
+        --idleCount_;
+        shard.idle_ = false;
+    }
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+void EventLoopPool<TShardSize, TLock, TCond, TShardCount>::stop()
+{
+    stopped_ = true;
+    for (auto& shard : shards_) {
+        std::lock_guard<LockType> guard(shard.lock_);
+        shard.cond_.notify();
+    }
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+void EventLoopPool<TShardSize, TLock, TCond, TShardCount>::reset()
+{
+    for (auto& shard : shards_) {
+        std::lock_guard<LockType> guard(shard.lock_);
+        shard.queue_.clear();
+        shard.busySize_ = 0;
+    }
+    stopped_ = false;
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+void EventLoopPool<TShardSize, TLock, TCond, TShardCount>::setDrainBudget(
+    std::size_t budget)
+{
+    drainBudget_ = budget;
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+template <typename TTask>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::postToShard(
+    std::size_t idx,
+    bool pinned,
+    TTask&& task)
+{
+    bool wakeIdle = false;
+    {
+        std::lock_guard<LockType> guard(shards_[idx].lock_);
+        if (!postNoLock(shards_[idx], pinned, std::forward<TTask>(task), wakeIdle)) {
+            return false;
+        }
+    }
+
+    if (wakeIdle) {
+        wakeIdleWorker(idx);
+    }
+    return true;
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+template <typename TTask>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::postToShardInterruptCtx(
+    std::size_t idx,
+    TTask&& task)
+{
+    // Waking up other workers requires acquiring regular context locks,
+    // only the worker of the target shard is notified.
+    InterruptLockWrapper<LockType> wrapperLock(shards_[idx].lock_);
+    std::lock_guard<decltype(wrapperLock)> guard(wrapperLock);
+    bool wakeIdle = false;
+    return postNoLock(shards_[idx], false, std::forward<TTask>(task), wakeIdle);
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+template <typename TTask>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::postNoLock(
+    Shard& shard,
+    bool pinned,
+    TTask&& task,
+    bool& wakeIdle)
+{
+    bool wasEmpty = shard.queue_.isEmpty();
+    bool result = false;
+    if (pinned) {
+        result = shard.queue_.pushPinned(std::forward<TTask>(task));
+    }
+    else {
+        result = shard.queue_.push(std::forward<TTask>(task));
+    }
+
+    if (!result) {
+        return false;
+    }
+
+    if (wasEmpty) {
+        shard.cond_.notify();
+    }
+
+    wakeIdle = (!pinned) && (!wasEmpty) && (0 < idleCount_);
+    return true;
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::execShard(
+    std::size_t idx)
+{
+    auto& shard = shards_[idx];
+    shard.lock_.lock();
+    if (stopped_ || shard.queue_.isEmpty()) {
+        shard.lock_.unlock();
+        return false;
+    }
+
+    auto snapshot = shard.queue_.snapshot(drainBudget_);
+    shard.busySize_ = ShardQueue::snapshotSize(snapshot);
+    shard.lock_.unlock();
+
+    std::size_t execCount = 0;
+    auto sizeToRemove = shard.queue_.exec(snapshot, 0, execCount, stopped_);
+
+    shard.lock_.lock();
+    shard.queue_.release(sizeToRemove);
+    shard.busySize_ = 0;
+    shard.lock_.unlock();
+    return true;
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+bool EventLoopPool<TShardSize, TLock, TCond, TShardCount>::steal(
+    std::size_t idx)
+{
+    auto& thief = shards_[idx];
+    for (auto offset = 1U; offset < TShardCount; ++offset) {
+        auto victimIdx = (idx + offset) % TShardCount;
+        auto& victim = shards_[victimIdx];
+
+        // Locks are always acquired in order of shard indices to
+        // avoid deadlock between two stealing workers.
+        auto& firstLock = (idx < victimIdx) ? thief.lock_ : victim.lock_;
+        auto& secondLock = (idx < victimIdx) ? victim.lock_ : thief.lock_;
+        std::lock_guard<LockType> firstGuard(firstLock);
+        std::lock_guard<LockType> secondGuard(secondLock);
+
+        if (victim.queue_.stealTo(thief.queue_, victim.busySize_)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+void EventLoopPool<TShardSize, TLock, TCond, TShardCount>::wakeIdleWorker(
+    std::size_t busyIdx)
+{
+    for (auto offset = 1U; offset < TShardCount; ++offset) {
+        auto& shard = shards_[(busyIdx + offset) % TShardCount];
+        std::lock_guard<LockType> guard(shard.lock_);
+        if (shard.idle_) {
+            shard.cond_.notify();
+            return;
+        }
+    }
+}
+
+template <std::size_t TShardSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TShardCount>
+std::size_t EventLoopPool<TShardSize, TLock, TCond, TShardCount>::nextShardIdx()
+{
+    return nextShard_.fetch_add(1, std::memory_order_relaxed) % TShardCount;
+}
+
+}  // namespace util
+
+}  // namespace embxx
@@ -0,0 +1,326 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/EventLoopStats.h
+/// Contains statistics policies for embxx::util::EventLoop.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+
+namespace embxx
+{
+
+namespace util
+{
+
+/// @addtogroup util
+/// @{
+
+/// @brief Default statistics policy of embxx::util::EventLoop.
+/// @details Doesn't collect anything, all the hooks are empty inline
+///          functions and get optimised away by the compiler.
+/// @headerfile embxx/util/EventLoopStats.h
+class EventLoopNoStats
+{
+public:
+    /// @brief Type of the record stored in the queue for the posted handler.
+    template <typename TTask>
+    struct WrappedTask
+    {
+        /// @brief Handler itself.
+        typedef typename std::decay<TTask>::type Type;
+    };
+
+    /// @brief Hook called when handler is posted.
+    /// @details The returned object is used to construct the
+    ///          WrappedTask::Type record only after the space for it
+    ///          has been reserved in the queue.
+    /// @return Forwarded handler itself.
+    template <typename TTask>
+    TTask&& wrap(TTask&& task)
+    {
+        return std::forward<TTask>(task);
+    }
+
+    /// @brief Hook called after handler was successfully posted.
+    void posted(std::size_t queueBytes)
+    {
+        static_cast<void>(queueBytes);
+    }
+
+    /// @brief Hook called when handler posting fails due to lack of space.
+    void postFailed()
+    {
+    }
+};
+
+/// @brief Statistics policy of embxx::util::EventLoop that collects
+///        queue usage and handler timing information.
+/// @details Records the following information:
+///          @li High-watermark of the queue usage in bytes, including
+///              the spill area.
+///          @li Number of posted handlers and posting failures.
+///          @li Histogram of time between posting and start of the
+///              execution of the handler.
+///          @li Histogram of handler execution durations.
+///
+///          The histograms are log-bucketed: bucket 0 counts the values
+///          of 0, bucket i (0 < i) counts the values in range
+///          [2^(i-1), 2^i), the last bucket also counts all the greater
+///          values. All the counters are atomic and may be read from
+///          any thread (or interrupt) using snapshot().
+///
+///          To measure the time every posted handler gets wrapped with
+///          an object that contains the time of posting, i.e. the
+///          enabled statistics increase the space required by every
+///          handler. The wrapping record is constructed directly in the
+///          queue, the handler is not moved from if the post fails.
+/// @tparam TClock Clock class. It must provide the following static
+///         function that returns current time in any units (such as
+///         system ticks or CPU cycles):
+///         @code static std::uint32_t now(); @endcode
+///         The counter is allowed to wrap around.
+/// @tparam TBucketCount Number of histogram buckets.
+/// @headerfile embxx/util/EventLoopStats.h
+template <typename TClock, std::size_t TBucketCount = 16>
+class EventLoopStats
+{
+    static_assert(1 < TBucketCount, "At least two buckets are required");
+public:
+    /// @brief Type of the time value
+    typedef std::uint32_t TimeType;
+
+    /// @brief Histogram type
+    typedef std::array<std::uint32_t, TBucketCount> Histogram;
+
+    /// @brief Plain copy of the collected statistics.
+    struct Snapshot
+    {
+        std::size_t queueHighWatermark; ///< Maximal number of used bytes
+        std::uint32_t postCount; ///< Number of successfully posted handlers
+        std::uint32_t postFailures; ///< Number of failed post attempts
+        Histogram latency; ///< Histogram of time from post to execution
+        Histogram duration; ///< Histogram of execution durations
+    };
+
+    /// @brief Constructor
+    EventLoopStats();
+
+    /// @brief Get copy of the currently collected statistics.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    Snapshot snapshot() const;
+
+    /// @brief Reset all the collected statistics.
+    /// @note Thread safety: Safe, but the update of the statistics
+    ///       performed concurrently may be partially lost.
+    /// @note Exception guarantee: No throw
+    void reset();
+
+    /// @brief Get index of histogram bucket for provided value.
+    static std::size_t bucketIdx(TimeType value);
+
+    /// @cond DOCUMENT_EVENT_LOOP_STATS_HOOKS
+    template <typename TTask>
+    class StampedTaskInit
+    {
+    public:
+        StampedTaskInit(EventLoopStats& stats, TTask&& task);
+
+        EventLoopStats& stats_;
+        TTask&& task_;
+    };
+
+    template <typename TTask>
+    class StampedTask
+    {
+    public:
+        template <typename TInitTask>
+        explicit StampedTask(StampedTaskInit<TInitTask>&& init);
+
+        void operator()();
+
+    private:
+        EventLoopStats& stats_;
+        TimeType postTime_;
+        TTask task_;
+    };
+
+    template <typename TTask>
+    struct WrappedTask
+    {
+        typedef StampedTask<typename std::decay<TTask>::type> Type;
+    };
+
+    template <typename TTask>
+    StampedTaskInit<TTask> wrap(TTask&& task);
+
+    void posted(std::size_t queueBytes);
+
+    void postFailed();
+    /// @endcond
+
+private:
+    typedef std::array<std::atomic<std::uint32_t>, TBucketCount> AtomicHistogram;
+
+    static void add(AtomicHistogram& histogram, TimeType value);
+    static void copy(const AtomicHistogram& from, Histogram& to);
+    static void clear(AtomicHistogram& histogram);
+
+    std::atomic<std::size_t> queueHighWatermark_;
+    std::atomic<std::uint32_t> postCount_;
+    std::atomic<std::uint32_t> postFailures_;
+    AtomicHistogram latency_;
+    AtomicHistogram duration_;
+};
+
+/// @}
+
+// Implementation
+template <typename TClock, std::size_t TBucketCount>
+EventLoopStats<TClock, TBucketCount>::EventLoopStats()
+{
+    reset();
+}
+
+template <typename TClock, std::size_t TBucketCount>
+typename EventLoopStats<TClock, TBucketCount>::Snapshot
+EventLoopStats<TClock, TBucketCount>::snapshot() const
+{
+    Snapshot snap;
+    snap.queueHighWatermark = queueHighWatermark_.load(std::memory_order_relaxed);
+    snap.postCount = postCount_.load(std::memory_order_relaxed);
+    snap.postFailures = postFailures_.load(std::memory_order_relaxed);
+    copy(latency_, snap.latency);
+    copy(duration_, snap.duration);
+    return snap;
+}
+
+template <typename TClock, std::size_t TBucketCount>
+void EventLoopStats<TClock, TBucketCount>::reset()
+{
+    queueHighWatermark_.store(0, std::memory_order_relaxed);
+    postCount_.store(0, std::memory_order_relaxed);
+    postFailures_.store(0, std::memory_order_relaxed);
+    clear(latency_);
+    clear(duration_);
+}
+
+template <typename TClock, std::size_t TBucketCount>
+std::size_t EventLoopStats<TClock, TBucketCount>::bucketIdx(TimeType value)
+{
+    std::size_t idx = 0;
+    while ((value != 0) && (idx < (TBucketCount - 1))) {
+        value >>= 1;
+        ++idx;
+    }
+    return idx;
+}
+
+template <typename TClock, std::size_t TBucketCount>
+template <typename TTask>
+typename EventLoopStats<TClock, TBucketCount>::template StampedTaskInit<TTask>
+EventLoopStats<TClock, TBucketCount>::wrap(TTask&& task)
+{
+    return StampedTaskInit<TTask>(*this, std::forward<TTask>(task));
+}
+
+template <typename TClock, std::size_t TBucketCount>
+void EventLoopStats<TClock, TBucketCount>::posted(std::size_t queueBytes)
+{
+    postCount_.fetch_add(1, std::memory_order_relaxed);
+
+    // Called with the event loop lock held, there is only one writer
+    if (queueHighWatermark_.load(std::memory_order_relaxed) < queueBytes) {
+        queueHighWatermark_.store(queueBytes, std::memory_order_relaxed);
+    }
+}
+
+template <typename TClock, std::size_t TBucketCount>
+void EventLoopStats<TClock, TBucketCount>::postFailed()
+{
+    postFailures_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename TClock, std::size_t TBucketCount>
+void EventLoopStats<TClock, TBucketCount>::add(
+    AtomicHistogram& histogram,
+    TimeType value)
+{
+    histogram[bucketIdx(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename TClock, std::size_t TBucketCount>
+void EventLoopStats<TClock, TBucketCount>::copy(
+    const AtomicHistogram& from,
+    Histogram& to)
+{
+    for (auto idx = 0U; idx < TBucketCount; ++idx) {
+        to[idx] = from[idx].load(std::memory_order_relaxed);
+    }
+}
+
+template <typename TClock, std::size_t TBucketCount>
+void EventLoopStats<TClock, TBucketCount>::clear(AtomicHistogram& histogram)
+{
+    for (auto& bucket : histogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+/// @cond DOCUMENT_EVENT_LOOP_STATS_HOOKS
+template <typename TClock, std::size_t TBucketCount>
+template <typename TTask>
+EventLoopStats<TClock, TBucketCount>::StampedTaskInit<TTask>::StampedTaskInit(
+    EventLoopStats& stats,
+    TTask&& task)
+    : stats_(stats),
+      task_(std::forward<TTask>(task))
+{
+}
+
+template <typename TClock, std::size_t TBucketCount>
+template <typename TTask>
+template <typename TInitTask>
+EventLoopStats<TClock, TBucketCount>::StampedTask<TTask>::StampedTask(
+    StampedTaskInit<TInitTask>&& init)
+    : stats_(init.stats_),
+      postTime_(TClock::now()),
+      task_(std::forward<TInitTask>(init.task_))
+{
+}
+
+template <typename TClock, std::size_t TBucketCount>
+template <typename TTask>
+void EventLoopStats<TClock, TBucketCount>::StampedTask<TTask>::operator()()
+{
+    auto startTime = TClock::now();
+    add(stats_.latency_, static_cast<TimeType>(startTime - postTime_));
+    task_();
+    add(stats_.duration_, static_cast<TimeType>(TClock::now() - startTime));
+}
+/// @endcond
+
+}  // namespace util
+
+}  // namespace embxx
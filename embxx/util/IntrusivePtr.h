@@ -0,0 +1,523 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/IntrusivePtr.h
+/// This file contains definition of the intrusive reference counted
+/// pointer and the allocation policy that produces it.
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <type_traits>
+
+#include "embxx/util/Assert.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+template <typename T>
+class IntrusivePtr;
+
+template <typename TAllocator, typename TLock>
+class IntrusivePtrAllocator;
+
+/// @cond DOCUMENT_INTRUSIVE_PTR_DETAILS
+namespace details
+{
+
+template <bool TThreadSafe>
+class RefCounter
+{
+public:
+    RefCounter() : count_(0) {}
+
+    void increment()
+    {
+        ++count_;
+    }
+
+    bool decrement()
+    {
+        GASSERT(0 < count_);
+        --count_;
+        return count_ == 0;
+    }
+
+    std::size_t value() const
+    {
+        return count_;
+    }
+
+private:
+    std::size_t count_;
+};
+
+template <>
+class RefCounter<true>
+{
+public:
+    RefCounter() : count_(0) {}
+
+    void increment()
+    {
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool decrement()
+    {
+        // Changes done by other owners must be visible to the one
+        // that destructs the object.
+        auto prev = count_.fetch_sub(1, std::memory_order_acq_rel);
+        GASSERT(0 < prev);
+        return prev == 1;
+    }
+
+    std::size_t value() const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::size_t> count_;
+};
+
+template <typename TLock>
+class IntrusivePtrAllocatorLock
+{
+public:
+    static const bool Synchronised = true;
+
+    void lock()
+    {
+        lock_.lock();
+    }
+
+    void unlock()
+    {
+        lock_.unlock();
+    }
+
+private:
+    TLock lock_;
+};
+
+template <>
+class IntrusivePtrAllocatorLock<void>
+{
+public:
+    static const bool Synchronised = false;
+
+    void lock() {}
+    void unlock() {}
+};
+
+}  // namespace details
+/// @endcond
+
+/// @addtogroup util
+/// @{
+
+/// @brief Base class for the objects managed by embxx::util::IntrusivePtr.
+/// @details Contains reference counter, pointer to the allocator of the
+///          object and pointer to the function that is invoked with them
+///          when the last reference is released. Both are set by
+///          embxx::util::IntrusivePtrAllocator, the function destructs the
+///          object and returns its storage to the allocator. The object
+///          must be derived from this class, usually via the common base
+///          class, such as message interface class in "comms" module.
+///
+///          Copying of the object doesn't copy the reference count and
+///          the releaser, the copy is not managed by any IntrusivePtr.
+/// @tparam TThreadSafe Use atomic reference counter, required when the
+///         references are held and released by multiple threads. In this
+///         case the allocator must be synchronised as well, see
+///         embxx::util::IntrusivePtrAllocator.
+/// @headerfile embxx/util/IntrusivePtr.h
+template <bool TThreadSafe = false>
+class RefCounted
+{
+    template <typename T>
+    friend class IntrusivePtr;
+
+    template <typename TAllocator, typename TLock>
+    friend class IntrusivePtrAllocator;
+
+public:
+    /// @brief Current number of references.
+    /// @note Thread safety: Safe
+    std::size_t refCount() const
+    {
+        return count_.value();
+    }
+
+protected:
+    /// @brief Default constructor
+    RefCounted()
+        : owner_(nullptr),
+          release_(nullptr)
+    {
+    }
+
+    /// @brief Copy constructor
+    /// @details Doesn't copy anything, the new object has no references.
+    RefCounted(const RefCounted&)
+        : owner_(nullptr),
+          release_(nullptr)
+    {
+    }
+
+    /// @brief Destructor
+    ~RefCounted()
+    {
+        GASSERT(count_.value() == 0);
+    }
+
+    /// @brief Copy assignment operator
+    /// @details Doesn't change the reference count.
+    RefCounted& operator=(const RefCounted&)
+    {
+        return *this;
+    }
+
+private:
+    typedef RefCounted RefCountedBase;
+    typedef void (*ReleaseFunc)(void* owner, RefCounted& obj);
+
+    static const bool ThreadSafeRefCount = TThreadSafe;
+
+    void addRef()
+    {
+        count_.increment();
+    }
+
+    void releaseRef()
+    {
+        if (!count_.decrement()) {
+            return;
+        }
+
+        if (release_ != nullptr) {
+            release_(owner_, *this);
+        }
+    }
+
+    void setReleaser(void* owner, ReleaseFunc func)
+    {
+        GASSERT(release_ == nullptr);
+        owner_ = owner;
+        release_ = func;
+    }
+
+    details::RefCounter<TThreadSafe> count_;
+    void* owner_;
+    ReleaseFunc release_;
+};
+
+/// @brief Intrusive reference counted pointer.
+/// @details Similar to std::shared_ptr, but the reference counter is stored
+///          inside the object, which must be derived from
+///          embxx::util::RefCounted. Copying of the pointer doesn't copy the
+///          object, it increments the reference counter, so the same object
+///          (such as decoded message) may be passed to multiple handlers
+///          without copying it. When the last reference is released, the
+///          object is destructed and its storage is returned to the allocator
+///          that created it (see embxx::util::IntrusivePtrAllocator).
+/// @tparam T Type of the object.
+/// @note Thread safety: Distinct IntrusivePtr objects referencing the same
+///       object may be used by multiple threads if the object uses
+///       thread safe reference counter.
+/// @headerfile embxx/util/IntrusivePtr.h
+template <typename T>
+class IntrusivePtr
+{
+    template <typename U>
+    friend class IntrusivePtr;
+
+public:
+    /// @brief Type of the referenced object
+    typedef T element_type;
+
+    /// @brief Default constructor
+    /// @details Creates empty pointer.
+    IntrusivePtr()
+        : ptr_(nullptr)
+    {
+    }
+
+    /// @brief Constructor
+    /// @details Adds reference to the provided object
+    explicit IntrusivePtr(T* ptr)
+        : ptr_(ptr)
+    {
+        addRef();
+    }
+
+    /// @brief Copy constructor
+    IntrusivePtr(const IntrusivePtr& other)
+        : ptr_(other.ptr_)
+    {
+        addRef();
+    }
+
+    /// @brief Converting copy constructor
+    template <typename U>
+    IntrusivePtr(const IntrusivePtr<U>& other)
+        : ptr_(other.ptr_)
+    {
+        addRef();
+    }
+
+    /// @brief Move constructor
+    IntrusivePtr(IntrusivePtr&& other)
+        : ptr_(other.ptr_)
+    {
+        other.ptr_ = nullptr;
+    }
+
+    /// @brief Converting move constructor
+    template <typename U>
+    IntrusivePtr(IntrusivePtr<U>&& other)
+        : ptr_(other.ptr_)
+    {
+        other.ptr_ = nullptr;
+    }
+
+    /// @brief Destructor
+    /// @details Releases the reference.
+    ~IntrusivePtr()
+    {
+        reset();
+    }
+
+    /// @brief Copy assignment operator
+    IntrusivePtr& operator=(const IntrusivePtr& other)
+    {
+        IntrusivePtr(other).swap(*this);
+        return *this;
+    }
+
+    /// @brief Converting copy assignment operator
+    template <typename U>
+    IntrusivePtr& operator=(const IntrusivePtr<U>& other)
+    {
+        IntrusivePtr(other).swap(*this);
+        return *this;
+    }
+
+    /// @brief Move assignment operator
+    IntrusivePtr& operator=(IntrusivePtr&& other)
+    {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    /// @brief Converting move assignment operator
+    template <typename U>
+    IntrusivePtr& operator=(IntrusivePtr<U>&& other)
+    {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    /// @brief Release the reference and make the pointer empty.
+    /// @details If it was the last reference, the object is destructed
+    ///          and its storage is released.
+    void reset()
+    {
+        if (ptr_ == nullptr) {
+            return;
+        }
+
+        auto* ptr = ptr_;
+        ptr_ = nullptr;
+        ptr->releaseRef();
+    }
+
+    /// @brief Swap contents with other pointer.
+    void swap(IntrusivePtr& other)
+    {
+        std::swap(ptr_, other.ptr_);
+    }
+
+    /// @brief Get raw pointer to the object.
+    T* get() const
+    {
+        return ptr_;
+    }
+
+    /// @brief Dereference operator.
+    /// @pre The pointer is not empty.
+    T& operator*() const
+    {
+        GASSERT(ptr_ != nullptr);
+        return *ptr_;
+    }
+
+    /// @brief Member access operator.
+    /// @pre The pointer is not empty.
+    T* operator->() const
+    {
+        GASSERT(ptr_ != nullptr);
+        return ptr_;
+    }
+
+    /// @brief Boolean conversion operator.
+    /// @return true if the pointer is not empty.
+    explicit operator bool() const
+    {
+        return ptr_ != nullptr;
+    }
+
+    /// @brief Current number of references to the object, 0 if the
+    ///        pointer is empty.
+    std::size_t useCount() const
+    {
+        if (ptr_ == nullptr) {
+            return 0;
+        }
+        return ptr_->refCount();
+    }
+
+private:
+    void addRef()
+    {
+        if (ptr_ != nullptr) {
+            ptr_->addRef();
+        }
+    }
+
+    T* ptr_;
+};
+
+/// @brief Equality comparison operator
+/// @related IntrusivePtr
+template <typename T, typename U>
+bool operator==(const IntrusivePtr<T>& ptr1, const IntrusivePtr<U>& ptr2)
+{
+    return ptr1.get() == ptr2.get();
+}
+
+/// @brief Inequality comparison operator
+/// @related IntrusivePtr
+template <typename T, typename U>
+bool operator!=(const IntrusivePtr<T>& ptr1, const IntrusivePtr<U>& ptr2)
+{
+    return !(ptr1 == ptr2);
+}
+
+/// @brief Object allocation policy that wraps the allocated objects in
+///        embxx::util::IntrusivePtr.
+/// @details Uses allocRaw() / deallocRaw() functions of the provided
+///          allocator, such as embxx::util::SpecificMultiSlotInPlaceAllocator,
+///          embxx::util::SizeClassInPlaceAllocator or
+///          embxx::util::StatsAllocator decorating any of them. Only the
+///          pointer to this object and the pointer to the release function
+///          are stored inside the allocated object (see
+///          embxx::util::RefCounted), the object is destructed and its
+///          storage is returned to the allocator when the last reference is
+///          released. It has the same alloc() interface as the other
+///          allocators, so it may be used as the allocator of
+///          embxx::comms::protocol::MsgIdLayer, which makes
+///          embxx::util::IntrusivePtr to the message base class its MsgPtr.
+/// @tparam TAllocator Allocator of the objects.
+/// @tparam TLock Lock type, such as std::mutex or the lock that disables
+///         interrupts, used to synchronise the allocations and releases.
+///         The objects with thread safe reference counter may be released
+///         by any thread, while the allocators are not thread safe, so the
+///         lock is required for them. The default void type means no
+///         locking, it may be used only for the objects with not thread
+///         safe reference counter, which is checked at compile time.
+/// @note Thread safety: Safe if TLock is not void, unsafe otherwise.
+/// @headerfile embxx/util/IntrusivePtr.h
+template <typename TAllocator, typename TLock = void>
+class IntrusivePtrAllocator : private details::IntrusivePtrAllocatorLock<TLock>
+{
+    typedef details::IntrusivePtrAllocatorLock<TLock> Lock;
+
+public:
+    /// @brief Type of the wrapped allocator
+    typedef TAllocator Allocator;
+
+    /// @brief Allocation function
+    /// @details Allocates the object using the wrapped allocator and
+    ///          installs its releaser.
+    /// @tparam TObj Type of object to by constructed, must be derived from
+    ///         embxx::util::RefCounted.
+    /// @tparam TArgs Types of the parameters required to create an object.
+    /// @return Pointer to the constructed object, empty if the wrapped
+    ///         allocator failed to allocate it.
+    template <typename TObj, typename... TArgs>
+    IntrusivePtr<TObj> alloc(TArgs&&... args)
+    {
+        static_assert((!TObj::ThreadSafeRefCount) || Lock::Synchronised,
+            "The object with thread safe reference counter may be released "
+            "by any thread, provide TLock to synchronise the allocator");
+
+        TObj* obj = nullptr;
+        {
+            std::lock_guard<Lock> guard(allocLock());
+            obj = allocator_.template allocRaw<TObj>(std::forward<TArgs>(args)...);
+        }
+
+        if (obj == nullptr) {
+            return IntrusivePtr<TObj>();
+        }
+
+        obj->setReleaser(this, &IntrusivePtrAllocator::template release<TObj>);
+        return IntrusivePtr<TObj>(obj);
+    }
+
+    /// @brief Get wrapped allocator.
+    Allocator& getAllocator()
+    {
+        return allocator_;
+    }
+
+    /// @brief Const version of getAllocator()
+    const Allocator& getAllocator() const
+    {
+        return allocator_;
+    }
+
+private:
+    Lock& allocLock()
+    {
+        return *this;
+    }
+
+    template <typename TObj>
+    static void release(void* owner, typename TObj::RefCountedBase& obj)
+    {
+        auto* thisPtr = static_cast<IntrusivePtrAllocator*>(owner);
+        std::lock_guard<Lock> guard(thisPtr->allocLock());
+        thisPtr->allocator_.deallocRaw(static_cast<TObj*>(&obj));
+    }
+
+    Allocator allocator_;
+};
+
+/// @}
+
+}  // namespace util
+
+}  // namespace embxx
@@ -0,0 +1,619 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/LockFreeEventLoop.h
+/// Contains LockFreeEventLoop class definition.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <mutex>
+#include <new>
+#include <array>
+#include <atomic>
+#include <limits>
+
+#include "embxx/util/Assert.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+/// @addtogroup util
+/// @{
+
+/// @brief Event loop with lock-free posting of new handlers.
+/// @details Provides the same interface as embxx::util::EventLoop, but the
+///          pending handlers are kept in bounded multi-producer /
+///          single-consumer ring. Producers reserve space in the ring
+///          using atomic compare-and-swap, construct the handler in place
+///          and publish it without acquiring the lock. The lock and the
+///          condition variable are used only to put the event loop to
+///          sleep when there are no pending handlers and to wake it up
+///          when new handler is posted.
+/// @tparam TSize Size in bytes to be allocated as data member for handlers
+///         registration. It cannot be changed afterwards.
+/// @tparam TLock "Lockable" class, same as for embxx::util::EventLoop.
+///         It is used only to protect sleep/wake up of the event loop.
+/// @tparam TCond Wait condition variable class, same as for
+///         embxx::util::EventLoop.
+/// @pre std::atomic<std::size_t> must be lock-free on the target platform
+///      if postInterruptCtx() is used.
+/// @headerfile embxx/util/LockFreeEventLoop.h
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+class LockFreeEventLoop
+{
+public:
+    /// @brief Type of the lock
+    typedef TLock LockType;
+
+    /// @brief Type of the condition variable
+    typedef TCond CondType;
+
+    /// @brief Constructor.
+    LockFreeEventLoop();
+
+    /// @brief Destructor
+    /// @details Destructs all the pending handlers without executing them.
+    ~LockFreeEventLoop();
+
+    /// @brief Get reference to the lock.
+    LockType& getLock();
+
+    /// @brief Get reference to the condition variable
+    CondType& getCond();
+
+    /// @brief Post new handler for execution.
+    /// @details Doesn't acquire any lock to add the handler to the execution
+    ///          queue. If the event loop is waiting for new handlers, the
+    ///          regular context lock is acquired and the condition variable
+    ///          is signalled by calling its notify() member function.
+    /// @param[in] task R-value reference to new handler functor.
+    /// @return true in case the handler was successfully posted, false if
+    ///         there is not enough space in the execution queue.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: Basic
+    template <typename TTask>
+    bool post(TTask&& task);
+
+    /// @brief Post new handler for execution from interrupt context.
+    /// @details Same as post(), but acquires interrupt context lock if
+    ///          the event loop needs to be woken up.
+    /// @param[in] task R-value reference to new handler functor.
+    /// @return true in case the handler was successfully posted, false if
+    ///         there is not enough space in the execution queue.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: Basic
+    template <typename TTask>
+    bool postInterruptCtx(TTask&& task);
+
+    /// @brief Event loop execution function.
+    /// @details Same as embxx::util::EventLoop::run(), but the lock is
+    ///          acquired only before waiting on the condition variable.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: Basic
+    void run();
+
+    /// @brief Stop execution of the event loop.
+    /// @details The execution may not be stopped immediately. If there is an
+    ///          event handler being executed, the loop will be stopped after
+    ///          the execution of the handler is finished.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    void stop();
+
+    /// @brief Reset the state of the event loop.
+    /// @details Destructs all the pending handlers without executing them
+    ///          and resets the "stopped" flag to allow new event loop
+    ///          execution.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: Basic
+    void reset();
+
+    /// @brief Perform busy wait.
+    /// @details Same as embxx::util::EventLoop::busyWait().
+    template <typename TPred, typename TFunc>
+    void busyWait(TPred&& pred, TFunc&& func);
+
+private:
+
+    /// @cond DOCUMENT_LOCK_FREE_EVENT_LOOP_TASK
+    class Task
+    {
+    public:
+        virtual ~Task();
+        virtual void exec();
+    };
+
+    template <typename TTask>
+    class TaskBound : public Task
+    {
+
+    public:
+        explicit TaskBound(const TTask& task);
+        explicit TaskBound(TTask&& task);
+        virtual ~TaskBound();
+
+        virtual void exec();
+
+        static const std::size_t Size =
+            ((sizeof(TaskBound<typename std::decay<TTask>::type>) - 1) / sizeof(Task)) + 1;
+
+    private:
+        TTask task_;
+    };
+    /// @endcond
+
+    /// @cond DOCUMENT_INTERRUPT_LOCK_WRAPPER
+    template <typename TInternalLock>
+    class InterruptLockWrapper
+    {
+    public:
+        InterruptLockWrapper(TInternalLock& intLock) : lock_(intLock) {}
+        void lock()
+        {
+            lock_.lockInterruptCtx();
+        }
+
+        void unlock()
+        {
+            lock_.unlockInterruptCtx();
+        }
+    private:
+        TInternalLock& lock_;
+    };
+    /// @endcond
+
+    typedef typename
+        std::aligned_storage<
+            sizeof(Task),
+            std::alignment_of<Task>::value
+        >::type ArrayElemType;
+
+    // Every record in the ring starts with a header element containing the
+    // size of the record (in elements) once the record is published, and
+    // 0 while it is still being written (or the space is free).
+    typedef std::atomic<std::size_t> Header;
+
+    static_assert(sizeof(Header) <= sizeof(ArrayElemType),
+        "Header must fit into single element of the ring");
+    static_assert(std::alignment_of<Header>::value <= std::alignment_of<ArrayElemType>::value,
+        "Header alignment mustn't exceed alignment of the ring element");
+
+    static const std::size_t HeaderSize = 1;
+    static const std::size_t ArraySize = TSize / sizeof(ArrayElemType);
+    static const std::size_t SkipFlag =
+        ~(std::numeric_limits<std::size_t>::max() >> 1);
+
+    // Read/write positions are free running counters wrapping at the
+    // greatest multiple of ArraySize, which makes the ABA problem on the
+    // compare-and-swap of the write position practically impossible.
+    static const std::size_t PosLimit =
+        (std::numeric_limits<std::size_t>::max() / ArraySize) * ArraySize;
+
+    typedef std::array<ArrayElemType, ArraySize> Array;
+
+    template <typename TTask, typename TNotifyLock>
+    bool postLockFree(TTask&& task, TNotifyLock& notifyLock);
+
+    bool execNext();
+    bool discardNext();
+    bool isReady() const;
+    void releaseRecord(std::size_t pos, std::size_t size);
+    Header& headerAt(std::size_t idx);
+    const Header& headerAt(std::size_t idx) const;
+
+    static std::size_t posToIdx(std::size_t pos);
+    static std::size_t advancePos(std::size_t pos, std::size_t count);
+    static std::size_t posDistance(std::size_t from, std::size_t to);
+
+    Array array_;
+    std::atomic<std::size_t> readPos_;
+    std::atomic<std::size_t> writePos_;
+    std::atomic<bool> sleeping_;
+    std::atomic<bool> stopped_;
+    LockType lock_;
+    CondType cond_;
+};
+
+/// @}
+
+// Implementation
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+LockFreeEventLoop<TSize, TLock, TCond>::LockFreeEventLoop()
+    : readPos_(0),
+      writePos_(0),
+      sleeping_(false),
+      stopped_(false)
+{
+    static_assert(0 < ArraySize, "The size of the event loop is too small");
+    for (auto& elem : array_) {
+        auto headerPtr = new (&elem) Header(0);
+        static_cast<void>(headerPtr);
+    }
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+LockFreeEventLoop<TSize, TLock, TCond>::~LockFreeEventLoop()
+{
+    while (discardNext()) {}
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+typename LockFreeEventLoop<TSize, TLock, TCond>::LockType&
+LockFreeEventLoop<TSize, TLock, TCond>::getLock()
+{
+    return lock_;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+typename LockFreeEventLoop<TSize, TLock, TCond>::CondType&
+LockFreeEventLoop<TSize, TLock, TCond>::getCond()
+{
+    return cond_;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+template <typename TTask>
+bool LockFreeEventLoop<TSize, TLock, TCond>::post(TTask&& task)
+{
+    return postLockFree(std::forward<TTask>(task), lock_);
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+template <typename TTask>
+bool LockFreeEventLoop<TSize, TLock, TCond>::postInterruptCtx(
+    TTask&& task)
+{
+    InterruptLockWrapper<LockType> wrapperLock(lock_);
+    return postLockFree(std::forward<TTask>(task), wrapperLock);
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+void LockFreeEventLoop<TSize, TLock, TCond>::run()
+{
+    while (true) {
+        while (!stopped_.load(std::memory_order_acquire)) {
+            if (!execNext()) {
+                break;
+            }
+        }
+
+        std::lock_guard<LockType> guard(lock_);
+        if (stopped_.load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!isReady()) {
+            cond_.wait(lock_);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+void LockFreeEventLoop<TSize, TLock, TCond>::stop()
+{
+    std::lock_guard<LockType> guard(lock_);
+    stopped_.store(true, std::memory_order_release);
+    cond_.notify();
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+void LockFreeEventLoop<TSize, TLock, TCond>::reset()
+{
+    std::lock_guard<LockType> guard(lock_);
+    stopped_.store(false, std::memory_order_relaxed);
+    while (discardNext()) {}
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+template <typename TPred, typename TFunc>
+void LockFreeEventLoop<TSize, TLock, TCond>::busyWait(TPred&& pred, TFunc&& func)
+{
+    if (pred()) {
+        bool result = post(std::forward<TFunc>(func));
+        GASSERT(result);
+        static_cast<void>(result);
+        return;
+    }
+
+    bool result = post(
+        [this, pred, func]()
+        {
+            busyWait(std::move(pred), std::move(func));
+        });
+    GASSERT(result);
+    static_cast<void>(result);
+}
+
+/// @cond DOCUMENT_LOCK_FREE_EVENT_LOOP_TASK
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+LockFreeEventLoop<TSize, TLock, TCond>::Task::~Task()
+{
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+void LockFreeEventLoop<TSize, TLock, TCond>::Task::exec()
+{
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+template <typename TTask>
+LockFreeEventLoop<TSize, TLock, TCond>::TaskBound<TTask>::TaskBound(const TTask& task)
+    : task_(task)
+{
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+template <typename TTask>
+LockFreeEventLoop<TSize, TLock, TCond>::TaskBound<TTask>::TaskBound(TTask&& task)
+    : task_(std::move(task))
+{
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+template <typename TTask>
+LockFreeEventLoop<TSize, TLock, TCond>::TaskBound<TTask>::~TaskBound()
+{
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+template <typename TTask>
+void LockFreeEventLoop<TSize, TLock, TCond>::TaskBound<TTask>::exec()
+{
+    task_();
+}
+
+/// @endcond
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+template <typename TTask, typename TNotifyLock>
+bool LockFreeEventLoop<TSize, TLock, TCond>::postLockFree(
+    TTask&& task,
+    TNotifyLock& notifyLock)
+{
+    typedef TaskBound<typename std::decay<TTask>::type> TaskBoundType;
+    static_assert(std::alignment_of<Task>::value == std::alignment_of<TaskBoundType>::value,
+        "Alignment of TaskBound must be same as alignment of Task");
+
+    static const std::size_t RecordSize = HeaderSize + TaskBoundType::Size;
+    static_assert(RecordSize <= ArraySize,
+        "The event loop is too small to contain the task");
+
+    // Reserve the space
+    auto writePos = writePos_.load(std::memory_order_relaxed);
+    std::size_t skipSize = 0;
+    while (true) {
+        auto readPos = readPos_.load(std::memory_order_acquire);
+        auto writeIdx = posToIdx(writePos);
+        skipSize = 0;
+        if (ArraySize < (writeIdx + RecordSize)) {
+            // The record cannot be split, skip till the end of the ring
+            skipSize = ArraySize - writeIdx;
+        }
+
+        auto freeSize = ArraySize - posDistance(readPos, writePos);
+        if (freeSize < (skipSize + RecordSize)) {
+            return false;
+        }
+
+        auto newWritePos = advancePos(writePos, skipSize + RecordSize);
+        if (writePos_.compare_exchange_weak(
+                writePos,
+                newWritePos,
+                std::memory_order_relaxed,
+                std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // Write and publish
+    auto idx = posToIdx(writePos);
+    if (0 < skipSize) {
+        headerAt(idx).store(skipSize | SkipFlag, std::memory_order_release);
+        idx = 0;
+    }
+
+    auto taskPtr = new (&array_[idx + HeaderSize]) TaskBoundType(std::forward<TTask>(task));
+    static_cast<void>(taskPtr);
+    headerAt(idx).store(RecordSize, std::memory_order_release);
+
+    // Wake up the event loop if it sleeps
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard<TNotifyLock> guard(notifyLock);
+        cond_.notify();
+    }
+
+    return true;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+bool LockFreeEventLoop<TSize, TLock, TCond>::execNext()
+{
+    auto readPos = readPos_.load(std::memory_order_relaxed);
+    auto idx = posToIdx(readPos);
+    auto size = headerAt(idx).load(std::memory_order_acquire);
+    if (size == 0) {
+        return false;
+    }
+
+    if ((size & SkipFlag) != 0) {
+        size &= ~SkipFlag;
+    }
+    else {
+        auto taskPtr = reinterpret_cast<Task*>(&array_[idx + HeaderSize]);
+        taskPtr->exec();
+        taskPtr->~Task();
+    }
+
+    releaseRecord(readPos, size);
+    return true;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+bool LockFreeEventLoop<TSize, TLock, TCond>::discardNext()
+{
+    auto readPos = readPos_.load(std::memory_order_relaxed);
+    auto idx = posToIdx(readPos);
+    auto size = headerAt(idx).load(std::memory_order_acquire);
+    if (size == 0) {
+        return false;
+    }
+
+    if ((size & SkipFlag) != 0) {
+        size &= ~SkipFlag;
+    }
+    else {
+        auto taskPtr = reinterpret_cast<Task*>(&array_[idx + HeaderSize]);
+        taskPtr->~Task();
+    }
+
+    releaseRecord(readPos, size);
+    return true;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+bool LockFreeEventLoop<TSize, TLock, TCond>::isReady() const
+{
+    auto readPos = readPos_.load(std::memory_order_relaxed);
+    return headerAt(posToIdx(readPos)).load(std::memory_order_relaxed) != 0;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+void LockFreeEventLoop<TSize, TLock, TCond>::releaseRecord(
+    std::size_t pos,
+    std::size_t size)
+{
+    auto idx = posToIdx(pos);
+    GASSERT((idx + size) <= ArraySize);
+    for (auto count = 0U; count < size; ++count) {
+        auto headerPtr = new (&array_[idx + count]) Header(0);
+        static_cast<void>(headerPtr);
+    }
+    readPos_.store(advancePos(pos, size), std::memory_order_release);
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+typename LockFreeEventLoop<TSize, TLock, TCond>::Header&
+LockFreeEventLoop<TSize, TLock, TCond>::headerAt(std::size_t idx)
+{
+    GASSERT(idx < ArraySize);
+    return *(reinterpret_cast<Header*>(&array_[idx]));
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+const typename LockFreeEventLoop<TSize, TLock, TCond>::Header&
+LockFreeEventLoop<TSize, TLock, TCond>::headerAt(std::size_t idx) const
+{
+    GASSERT(idx < ArraySize);
+    return *(reinterpret_cast<const Header*>(&array_[idx]));
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+std::size_t LockFreeEventLoop<TSize, TLock, TCond>::posToIdx(std::size_t pos)
+{
+    return pos % ArraySize;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+std::size_t LockFreeEventLoop<TSize, TLock, TCond>::advancePos(
+    std::size_t pos,
+    std::size_t count)
+{
+    GASSERT(pos < PosLimit);
+    auto remToLimit = PosLimit - pos;
+    if (remToLimit <= count) {
+        return count - remToLimit;
+    }
+    return pos + count;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond>
+std::size_t LockFreeEventLoop<TSize, TLock, TCond>::posDistance(
+    std::size_t from,
+    std::size_t to)
+{
+    if (from <= to) {
+        return to - from;
+    }
+    return (PosLimit - from) + to;
+}
+
+}  // namespace util
+
+}  // namespace embxx
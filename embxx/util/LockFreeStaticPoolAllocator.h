@@ -0,0 +1,312 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/LockFreeStaticPoolAllocator.h
+/// This file contains the definition and implementation of the static pool
+/// allocator that may be used concurrently from multiple threads and
+/// interrupt context.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <iterator>
+
+#include "embxx/util/Assert.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+namespace details
+{
+
+/// @cond DOCUMENT_STATIC_POOL_ALLOCATOR_STORAGE
+template <typename TTag, typename T, std::size_t TSize>
+struct LockFreeStaticPoolAllocatorStorage
+{
+    static_assert(0 < TSize, "The pool mustn't be empty");
+
+    typedef typename
+        std::aligned_storage<
+            sizeof(T),
+            std::alignment_of<T>::value
+        >::type CellType;
+
+    static const bool SmallPool =
+        (TSize < (std::numeric_limits<std::uint16_t>::max() - 1));
+
+    typedef typename std::conditional<
+        SmallPool,
+        std::uint16_t,
+        std::uint32_t
+    >::type IndexType;
+
+    // The head of the free list contains index of the first free cell
+    // in lower bits and modification counter (ABA tag) in upper bits.
+    // 32 bit counter is used whenever 64 bit atomics are lock-free,
+    // 16 bit one only for small pools on targets without them.
+    static const bool WideHead =
+        (ATOMIC_LLONG_LOCK_FREE == 2) || (!SmallPool);
+
+    typedef typename std::conditional<
+        WideHead,
+        std::uint64_t,
+        std::uint32_t
+    >::type HeadType;
+
+    static const std::size_t IndexBits = WideHead ? 32U : 16U;
+    static const HeadType IndexMask = (static_cast<HeadType>(1U) << IndexBits) - 1U;
+
+    // Zero initialised state of the static data is the valid initial state:
+    // the head refers to the first cell and zero "next" value of a cell
+    // refers to the following one. Otherwise "next" contains
+    // index of the next free cell + 1.
+    static CellType* allocate()
+    {
+        auto head = head_.load(std::memory_order_acquire);
+        while (true) {
+            auto idx = static_cast<std::size_t>(head & IndexMask);
+            if (TSize <= idx) {
+                return nullptr;
+            }
+
+            auto next = decodeNext(idx, next_[idx].load(std::memory_order_relaxed));
+            auto newHead = nextTag(head) | static_cast<HeadType>(next);
+            if (head_.compare_exchange_weak(
+                    head,
+                    newHead,
+                    std::memory_order_acquire,
+                    std::memory_order_acquire)) {
+                return &items_[idx];
+            }
+        }
+    }
+
+    static void deallocate(CellType* cell)
+    {
+        auto idxTmp = std::distance(&items_[0], cell);
+        GASSERT((0 <= idxTmp) && (static_cast<std::size_t>(idxTmp) < TSize));
+        auto idx = static_cast<HeadType>(idxTmp);
+
+        auto head = head_.load(std::memory_order_relaxed);
+        while (true) {
+            next_[idx].store(
+                static_cast<IndexType>((head & IndexMask) + 1),
+                std::memory_order_relaxed);
+            auto newHead = nextTag(head) | idx;
+            if (head_.compare_exchange_weak(
+                    head,
+                    newHead,
+                    std::memory_order_release,
+                    std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    static bool isLockFree()
+    {
+        return head_.is_lock_free() && next_[0].is_lock_free();
+    }
+
+    static std::array<CellType, TSize> items_;
+    static std::array<std::atomic<IndexType>, TSize> next_;
+    static std::atomic<HeadType> head_;
+
+private:
+    static std::size_t decodeNext(std::size_t idx, IndexType next)
+    {
+        if (next == 0) {
+            return idx + 1;
+        }
+        return static_cast<std::size_t>(next - 1);
+    }
+
+    static HeadType nextTag(HeadType head)
+    {
+        return ((head >> IndexBits) + 1) << IndexBits;
+    }
+};
+/// @endcond
+
+template <typename TTag, typename T, std::size_t TSize>
+std::array<typename LockFreeStaticPoolAllocatorStorage<TTag, T, TSize>::CellType, TSize>
+LockFreeStaticPoolAllocatorStorage<TTag, T, TSize>::items_;
+
+template <typename TTag, typename T, std::size_t TSize>
+std::array<
+    std::atomic<typename LockFreeStaticPoolAllocatorStorage<TTag, T, TSize>::IndexType>,
+    TSize>
+LockFreeStaticPoolAllocatorStorage<TTag, T, TSize>::next_;
+
+template <typename TTag, typename T, std::size_t TSize>
+std::atomic<typename LockFreeStaticPoolAllocatorStorage<TTag, T, TSize>::HeadType>
+LockFreeStaticPoolAllocatorStorage<TTag, T, TSize>::head_;
+
+}  // namespace details
+
+/// @addtogroup util
+/// @{
+
+/// @brief Lock-free allocator of single objects from the static pool.
+/// @details Similar to embxx::util::StaticPoolAllocator, i.e. the pool of
+///          TSize cells is statically allocated and shared by all the
+///          allocator objects with the same TTag, T and TSize parameters.
+///          However the free cells are kept in the lock-free stack (Treiber
+///          stack) with the modification counter preventing ABA problem
+///          (32 bit wide when 64 bit atomics are lock-free on the target),
+///          so the objects may be allocated and deallocated concurrently by
+///          multiple threads, such as producer threads and the event loop
+///          thread, as well as in interrupt context, provided the atomic
+///          operations are lock-free on the target (see isLockFree()).
+///          Only single object allocation is supported, allocate() with
+///          any other number of objects returns nullptr.
+/// @tparam TTag Tag type to distinguish between pools of the same object type.
+/// @tparam T Type of the allocated object.
+/// @tparam TSize Number of cells in the pool.
+/// @headerfile embxx/util/LockFreeStaticPoolAllocator.h
+template <typename TTag, typename T = void, std::size_t TSize = 1>
+class LockFreeStaticPoolAllocator
+{
+    static_assert(
+        std::is_same<typename std::remove_reference<T>::type, T>::value,
+        "Template parameter T to embxx::util::LockFreeStaticPoolAllocator "
+        "mustn't be reference");
+
+    typedef details::LockFreeStaticPoolAllocatorStorage<TTag, T, TSize> Storage;
+
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef LockFreeStaticPoolAllocator<TTag, U, TSize> other;
+    };
+
+    LockFreeStaticPoolAllocator() = default;
+    LockFreeStaticPoolAllocator(const LockFreeStaticPoolAllocator&) = default;
+    LockFreeStaticPoolAllocator(LockFreeStaticPoolAllocator&&) = default;
+    ~LockFreeStaticPoolAllocator() = default;
+    LockFreeStaticPoolAllocator& operator=(const LockFreeStaticPoolAllocator&) = default;
+    LockFreeStaticPoolAllocator& operator=(LockFreeStaticPoolAllocator&&) = default;
+
+    template <typename U>
+    LockFreeStaticPoolAllocator(const LockFreeStaticPoolAllocator<TTag, U, TSize>&)
+    {
+    }
+
+    /// @brief Allocate single object.
+    /// @param[in] num Number of objects, must be 1.
+    /// @return Pointer to the allocated space, nullptr if the pool is
+    ///         exhausted or num is not 1.
+    /// @note Thread safety: Safe
+    pointer allocate(size_type num)
+    {
+        if (num != 1U) {
+            return nullptr;
+        }
+        return reinterpret_cast<pointer>(Storage::allocate());
+    }
+
+    /// @brief Deallocate the object allocated by allocate().
+    /// @note Thread safety: Safe
+    void deallocate(pointer ptr, size_type num)
+    {
+        static_cast<void>(num);
+        GASSERT(num == 1U);
+        Storage::deallocate(reinterpret_cast<typename Storage::CellType*>(ptr));
+    }
+
+    constexpr size_type max_size() const
+    {
+        return TSize;
+    }
+
+    /// @brief Check whether the atomic operations used by the allocator
+    ///        are lock-free, i.e. the allocator may be used in interrupt
+    ///        context.
+    static bool isLockFree()
+    {
+        return Storage::isLockFree();
+    }
+};
+
+template <typename TTag, std::size_t TSize>
+class LockFreeStaticPoolAllocator<TTag, void, TSize>
+{
+public:
+    typedef void value_type;
+    typedef void* pointer;
+    typedef const void* const_pointer;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef LockFreeStaticPoolAllocator<TTag, U, TSize> other;
+    };
+
+    LockFreeStaticPoolAllocator() = default;
+    LockFreeStaticPoolAllocator(const LockFreeStaticPoolAllocator&) = default;
+    LockFreeStaticPoolAllocator(LockFreeStaticPoolAllocator&&) = default;
+    ~LockFreeStaticPoolAllocator() = default;
+    LockFreeStaticPoolAllocator& operator=(const LockFreeStaticPoolAllocator&) = default;
+    LockFreeStaticPoolAllocator& operator=(LockFreeStaticPoolAllocator&&) = default;
+};
+
+template <typename TTag, typename T, std::size_t TSize>
+bool operator==(
+    const LockFreeStaticPoolAllocator<TTag, T, TSize>,
+    const LockFreeStaticPoolAllocator<TTag, T, TSize>)
+{
+    return true;
+}
+
+template <typename TTag1, typename T1, std::size_t TSize1, typename TTag2, typename T2, std::size_t TSize2>
+bool operator==(
+    const LockFreeStaticPoolAllocator<TTag1, T1, TSize1>,
+    const LockFreeStaticPoolAllocator<TTag2, T2, TSize2>)
+{
+    return false;
+}
+
+template <typename TTag1, typename T1, std::size_t TSize1, typename TTag2, typename T2, std::size_t TSize2>
+bool operator!=(
+    const LockFreeStaticPoolAllocator<TTag1, T1, TSize1> a1,
+    const LockFreeStaticPoolAllocator<TTag2, T2, TSize2> a2)
+{
+    return !(a1 == a2);
+}
+
+/// @}
+
+}  // namespace util
+
+}  // namespace embxx
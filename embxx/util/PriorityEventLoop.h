@@ -0,0 +1,531 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/PriorityEventLoop.h
+/// Contains PriorityEventLoop class definition.
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <array>
+
+#include "embxx/util/EventLoop.h"
+#include "embxx/util/ScopeGuard.h"
+#include "embxx/util/Assert.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+/// @addtogroup util
+/// @{
+
+/// @brief Event loop with multiple priority lanes.
+/// @details Similar to embxx::util::EventLoop, but the handlers are posted
+///          into one of the TPriorityCount lanes, each having its own
+///          in place queue. The run() function always executes the handlers
+///          from the highest priority (lowest index) non-empty lane first.
+///          Lane 0 has the highest priority, the regular post() and
+///          postInterruptCtx() functions use the lowest priority
+///          lane (TPriorityCount - 1), which allows usage of this event
+///          loop as a drop-in replacement of embxx::util::EventLoop.
+/// @tparam TSize Size in bytes to be allocated as data member for handlers
+///         registration. It is evenly split between all the lanes.
+/// @tparam TLock "Lockable" class, same as for embxx::util::EventLoop.
+/// @tparam TCond Wait condition variable class, same as for
+///         embxx::util::EventLoop.
+/// @tparam TPriorityCount Number of priority lanes.
+/// @headerfile embxx/util/PriorityEventLoop.h
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+class PriorityEventLoop
+{
+    static_assert(0 < TPriorityCount, "At least one priority lane is required");
+
+public:
+    /// @brief Type of the lock
+    typedef TLock LockType;
+
+    /// @brief Type of the condition variable
+    typedef TCond CondType;
+
+    /// @brief Number of priority lanes.
+    static const std::size_t PriorityCount = TPriorityCount;
+
+    /// @brief Priority used by post() and postInterruptCtx() when none
+    ///        is specified.
+    static const std::size_t DefaultPriority = TPriorityCount - 1;
+
+    /// @brief Adapter that posts all the handlers into specific lane.
+    /// @details Provides the post() and postInterruptCtx() member functions
+    ///          and can be passed to drivers (such as
+    ///          embxx::driver::TimerMgr) as their event loop to make
+    ///          all their handlers use the specified priority.
+    /// @tparam TPriority Priority of the lane.
+    template <std::size_t TPriority>
+    class Lane
+    {
+        static_assert(TPriority < TPriorityCount, "Invalid priority");
+    public:
+        /// @brief Type of the lock
+        typedef typename PriorityEventLoop::LockType LockType;
+
+        /// @brief Type of the condition variable
+        typedef typename PriorityEventLoop::CondType CondType;
+
+        /// @brief Constructor
+        /// @param el Reference to the event loop.
+        explicit Lane(PriorityEventLoop& el) : el_(el) {}
+
+        /// @brief Get reference to the lock of the event loop.
+        LockType& getLock()
+        {
+            return el_.getLock();
+        }
+
+        /// @brief Get reference to the condition variable of the event loop.
+        CondType& getCond()
+        {
+            return el_.getCond();
+        }
+
+        /// @brief Same as PriorityEventLoop::post<TPriority>(task).
+        template <typename TTask>
+        bool post(TTask&& task)
+        {
+            return el_.template post<TPriority>(std::forward<TTask>(task));
+        }
+
+        /// @brief Same as PriorityEventLoop::postInterruptCtx<TPriority>(task).
+        template <typename TTask>
+        bool postInterruptCtx(TTask&& task)
+        {
+            return el_.template postInterruptCtx<TPriority>(std::forward<TTask>(task));
+        }
+
+    private:
+        PriorityEventLoop& el_;
+    };
+
+    /// @brief Constructor.
+    PriorityEventLoop();
+
+    /// @brief Destructor
+    ~PriorityEventLoop() = default;
+
+    /// @brief Get reference to the lock.
+    LockType& getLock();
+
+    /// @brief Get reference to the condition variable
+    CondType& getCond();
+
+    /// @brief Post new handler for execution into specified lane.
+    /// @details Acquires regular context lock. The task is added to the
+    ///          queue of the specified lane. If the lane is empty before the
+    ///          new handler is added, the condition variable is signalled by
+    ///          calling its notify() member function.
+    /// @tparam TPriority Priority of the lane, 0 is the highest.
+    /// @param[in] task R-value reference to new handler functor.
+    /// @return true in case the handler was successfully posted, false if
+    ///         there is not enough space in the queue of the lane.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: Basic
+    template <std::size_t TPriority, typename TTask>
+    bool post(TTask&& task);
+
+    /// @brief Post new handler for execution into the lowest priority lane.
+    /// @details Same as post<DefaultPriority>(task).
+    template <typename TTask>
+    bool post(TTask&& task);
+
+    /// @brief Post new handler for execution into specified lane from
+    ///        interrupt context.
+    /// @details Acquires interrupt context lock. The task is added to the
+    ///          queue of the specified lane. If the lane is empty before the
+    ///          new handler is added, the condition variable is signalled by
+    ///          calling its notify() member function.
+    /// @tparam TPriority Priority of the lane, 0 is the highest.
+    /// @param[in] task R-value reference to new handler functor.
+    /// @return true in case the handler was successfully posted, false if
+    ///         there is not enough space in the queue of the lane.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: Basic
+    template <std::size_t TPriority, typename TTask>
+    bool postInterruptCtx(TTask&& task);
+
+    /// @brief Post new handler for execution into the lowest priority lane
+    ///        from interrupt context.
+    /// @details Same as postInterruptCtx<DefaultPriority>(task).
+    template <typename TTask>
+    bool postInterruptCtx(TTask&& task);
+
+    /// @brief Event loop execution function.
+    /// @details Same as embxx::util::EventLoop::run(), but every drain of
+    ///          handlers is performed on the highest priority non-empty lane.
+    ///          Between the drains all the lanes are re-inspected, i.e. the
+    ///          handler posted into the higher priority lane is executed
+    ///          right after the current drain is complete. The size of the
+    ///          drain is controlled by setDrainBudget(). If starvation
+    ///          protection is enabled by setStarvationLimit(), the lower
+    ///          priority lanes are periodically served even if higher
+    ///          priority ones are not empty.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: Basic
+    void run();
+
+    /// @brief Stop execution of the event loop.
+    /// @details Same as embxx::util::EventLoop::stop().
+    void stop();
+
+    /// @brief Reset the state of the event loop.
+    /// @details Clear the queues of all the lanes and resets the
+    ///          "stopped" flag to allow new event loop execution.
+    /// @note Thread safety: Unsafe
+    /// @note Exception guarantee: Basic
+    void reset();
+
+    /// @brief Perform busy wait.
+    /// @details Same as embxx::util::EventLoop::busyWait(). The reposted
+    ///          checks of the predicate as well as the final function are
+    ///          posted into the lowest priority lane.
+    template <typename TPred, typename TFunc>
+    void busyWait(TPred&& pred, TFunc&& func);
+
+    /// @brief Set maximal number of handlers executed per single drain.
+    /// @details Same as embxx::util::EventLoop::setDrainBudget(). Note that
+    ///          the higher priority lanes are inspected only between the
+    ///          drains, the default value of 1 provides the lowest latency
+    ///          of the high priority handlers.
+    /// @param budget Maximal number of handlers to execute per drain,
+    ///        0 means no limit.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    void setDrainBudget(std::size_t budget);
+
+    /// @brief Set starvation protection limit.
+    /// @details When set to non-zero value, the non-empty lower priority
+    ///          lane is drained after at most "limit" drains of higher
+    ///          priority lanes. Value 0 (default) disables the
+    ///          protection, i.e. lower priority lanes are served only when
+    ///          all higher priority lanes are empty.
+    /// @param limit Maximal number of times the lane may be skipped.
+    /// @note Thread safety: Safe
+    /// @note Exception guarantee: No throw
+    void setStarvationLimit(std::size_t limit);
+
+private:
+
+    /// @cond DOCUMENT_INTERRUPT_LOCK_WRAPPER
+    template <typename TInternalLock>
+    class InterruptLockWrapper
+    {
+    public:
+        InterruptLockWrapper(TInternalLock& intLock) : lock_(intLock) {}
+        void lock()
+        {
+            lock_.lockInterruptCtx();
+        }
+
+        void unlock()
+        {
+            lock_.unlockInterruptCtx();
+        }
+    private:
+        TInternalLock& lock_;
+    };
+    /// @endcond
+
+    typedef details::EventLoopQueue<TSize / TPriorityCount> LaneQueue;
+    typedef std::array<LaneQueue, TPriorityCount> Lanes;
+    typedef std::array<std::size_t, TPriorityCount> SkipCounts;
+
+    template <std::size_t TPriority, typename TTask>
+    bool postNoLock(TTask&& task);
+
+    std::size_t selectLane();
+
+    Lanes lanes_;
+    SkipCounts skipCounts_;
+    LockType lock_;
+    CondType cond_;
+    volatile bool stopped_;
+    std::size_t drainBudget_;
+    std::size_t starvationLimit_;
+};
+
+/// @}
+
+// Implementation
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::PriorityEventLoop()
+    : stopped_(false),
+      drainBudget_(1),
+      starvationLimit_(0)
+{
+    skipCounts_.fill(0);
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+typename PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::LockType&
+PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::getLock()
+{
+    return lock_;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+typename PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::CondType&
+PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::getCond()
+{
+    return cond_;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+template <std::size_t TPriority, typename TTask>
+bool PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::post(TTask&& task)
+{
+    std::lock_guard<LockType> guard(lock_);
+    return postNoLock<TPriority>(std::forward<TTask>(task));
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+template <typename TTask>
+bool PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::post(TTask&& task)
+{
+    return post<DefaultPriority>(std::forward<TTask>(task));
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+template <std::size_t TPriority, typename TTask>
+bool PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::postInterruptCtx(
+    TTask&& task)
+{
+    InterruptLockWrapper<LockType> wrapperLock(lock_);
+    std::lock_guard<decltype(wrapperLock)> guard(wrapperLock);
+    return postNoLock<TPriority>(std::forward<TTask>(task));
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+template <typename TTask>
+bool PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::postInterruptCtx(
+    TTask&& task)
+{
+    return postInterruptCtx<DefaultPriority>(std::forward<TTask>(task));
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+void PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::run()
+{
+    while (true) {
+        lock_.lock();
+        auto lockGuard = embxx::util::makeScopeGuard(
+            [this]()
+            {
+                lock_.unlock();
+            });
+
+        while (!stopped_) {
+            auto laneIdx = selectLane();
+            if (TPriorityCount <= laneIdx) {
+                break;
+            }
+
+            auto& lane = lanes_[laneIdx];
+            auto snapshot = lane.snapshot();
+            auto budget = drainBudget_;
+            lock_.unlock();
+
+            std::size_t execCount = 0;
+            auto sizeToRemove = lane.exec(snapshot, budget, execCount, stopped_);
+
+            lock_.lock();
+            lane.release(sizeToRemove);
+        }
+
+        if (stopped_) {
+            break;
+        }
+
+        // Still locked prior to wait
+        cond_.wait(lock_);
+    }
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+void PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::stop()
+{
+    std::lock_guard<LockType> guard(lock_);
+    stopped_ = true;
+    cond_.notify();
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+void PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::reset()
+{
+    std::lock_guard<LockType> guard(lock_);
+    stopped_ = false;
+    for (auto& lane : lanes_) {
+        lane.clear();
+    }
+    skipCounts_.fill(0);
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+template <typename TPred, typename TFunc>
+void PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::busyWait(
+    TPred&& pred,
+    TFunc&& func)
+{
+    if (pred()) {
+        bool result = post(std::forward<TFunc>(func));
+        GASSERT(result);
+        static_cast<void>(result);
+        return;
+    }
+
+    bool result = post(
+        [this, pred, func]()
+        {
+            busyWait(std::move(pred), std::move(func));
+        });
+    GASSERT(result);
+    static_cast<void>(result);
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+void PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::setDrainBudget(
+    std::size_t budget)
+{
+    std::lock_guard<LockType> guard(lock_);
+    drainBudget_ = budget;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+void PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::setStarvationLimit(
+    std::size_t limit)
+{
+    std::lock_guard<LockType> guard(lock_);
+    starvationLimit_ = limit;
+    skipCounts_.fill(0);
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+template <std::size_t TPriority, typename TTask>
+bool PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::postNoLock(
+    TTask&& task)
+{
+    static_assert(TPriority < TPriorityCount, "Invalid priority");
+
+    auto& lane = lanes_[TPriority];
+    bool wasEmpty = lane.isEmpty();
+    if (!lane.push(std::forward<TTask>(task))) {
+        return false;
+    }
+
+    if (wasEmpty) {
+        cond_.notify();
+    }
+
+    return true;
+}
+
+template <std::size_t TSize,
+          typename TLock,
+          typename TCond,
+          std::size_t TPriorityCount>
+std::size_t PriorityEventLoop<TSize, TLock, TCond, TPriorityCount>::selectLane()
+{
+    std::size_t topIdx = 0;
+    while ((topIdx < TPriorityCount) && lanes_[topIdx].isEmpty()) {
+        ++topIdx;
+    }
+
+    if ((TPriorityCount <= topIdx) || (starvationLimit_ == 0)) {
+        return topIdx;
+    }
+
+    // Every non-empty lane below the selected one is considered skipped.
+    // The highest priority lane that was skipped too many times gets
+    // selected instead of the top one.
+    auto selectedIdx = topIdx;
+    for (auto idx = topIdx + 1; idx < TPriorityCount; ++idx) {
+        if (lanes_[idx].isEmpty()) {
+            skipCounts_[idx] = 0;
+            continue;
+        }
+
+        if ((selectedIdx == topIdx) && (starvationLimit_ <= skipCounts_[idx])) {
+            selectedIdx = idx;
+            continue;
+        }
+
+        ++skipCounts_[idx];
+    }
+
+    skipCounts_[selectedIdx] = 0;
+    return selectedIdx;
+}
+
+}  // namespace util
+
+}  // namespace embxx
@@ -46,6 +46,14 @@ class StaticFunction;
 ///          use dynamic memory allocation, hence it must receive amount of space
 ///          required to store provided functor object.
 ///
+///          Besides the storage area the object contains only a pointer to
+///          the static table of operations generated for the type of the
+///          stored functor, there are no virtual functions. Null pointer
+///          indicates invalid (empty) function. Trivially copyable
+///          functors, such as captureless lambdas, function pointers or
+///          lambdas capturing references, are copied and moved by
+///          copying the storage area.
+///
 ///          This is template specialisation of the following class definition
 ///          @code
 ///          // TSignature is a combination of return value an arguments: TRet(TArgs...)
@@ -77,6 +85,9 @@ public:
     /// @brief Copy constructor
     StaticFunction(const StaticFunction& other);
 
+    /// @brief Non-const param copy constructor
+    StaticFunction(StaticFunction& other);
+
     /// @brief Move constructor
     StaticFunction(StaticFunction&& other);
 
@@ -132,51 +143,49 @@ public:
 
 private:
 
-    /// @cond DOCUMENT_STATIC_FUNCTION_INVOKER
-    class Invoker
+    /// @cond DOCUMENT_STATIC_FUNCTION_OPS
+    struct Ops
     {
-    public:
-        virtual ~Invoker();
-        virtual TRet exec(TArgs... args) const = 0;
-        virtual TRet exec(TArgs... args) = 0;
-        virtual void copyTo(void* other) const = 0;
-        virtual void moveTo(void* other) = 0;
-    private:
+        TRet (*invoke_)(void* storage, TArgs... args);
+        TRet (*invokeConst_)(const void* storage, TArgs... args);
+        void (*copy_)(void* to, const void* from); // nullptr for memcpy
+        void (*move_)(void* to, void* from); // nullptr for memcpy
+        void (*destroy_)(void* storage); // nullptr for trivial destructor
     };
 
     template <typename TBound>
-    class InvokerBound : public Invoker
-    {
-    public:
-        template <typename TFunc>
-        InvokerBound(TFunc&& func);
-        InvokerBound(const InvokerBound&) = default;
-        InvokerBound(InvokerBound&&) = default;
-        virtual ~InvokerBound();
-        virtual TRet exec(TArgs... args) const;
-        virtual TRet exec(TArgs... args);
-        virtual void copyTo(void* other) const;
-        virtual void moveTo(void* other);
-    private:
-        TBound func_;
-    };
+    static TRet invokeBound(void* storage, TArgs... args);
+
+    template <typename TBound>
+    static TRet invokeBoundConst(const void* storage, TArgs... args);
+
+    template <typename TBound>
+    static void copyBound(void* to, const void* from);
+
+    template <typename TBound>
+    static void moveBound(void* to, void* from);
+
+    template <typename TBound>
+    static void destroyBound(void* storage);
+
+    template <typename TBound>
+    static const Ops* getOps();
     /// @endcond
 
-    static const std::size_t StorageAreaSize = TSize + sizeof(Invoker);
     typedef typename
         std::aligned_storage<
-            StorageAreaSize,
-            std::alignment_of<Invoker>::value
+            TSize,
+            std::alignment_of<void*>::value
         >::type StorageType;
 
-    Invoker* getInvoker();
-    const Invoker* getInvoker() const;
     void destroyHandler();
+    void copyHandler(const StaticFunction& other);
+    void moveHandler(StaticFunction& other);
     template <typename TFunc>
     void assignHandler(TFunc&& func);
 
+    const Ops* ops_;
     StorageType handler_;
-    bool valid_;
 };
 
 /// @}
@@ -184,14 +193,14 @@ private:
 // Implementation
 template <std::size_t TSize, typename TRet, typename... TArgs>
 StaticFunction<TRet (TArgs...), TSize>::StaticFunction()
-    : valid_(false)
+    : ops_(nullptr)
 {
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 template <typename TFunc>
 StaticFunction<TRet (TArgs...), TSize>::StaticFunction(TFunc&& func)
-    : valid_(true)
+    : ops_(nullptr)
 {
     assignHandler(std::forward<TFunc>(func));
 }
@@ -199,24 +208,24 @@ StaticFunction<TRet (TArgs...), TSize>::StaticFunction(TFunc&& func)
 template <std::size_t TSize, typename TRet, typename... TArgs>
 StaticFunction<TRet (TArgs...), TSize>::StaticFunction(
     const StaticFunction& other)
-    : valid_(other.valid_)
+    : ops_(nullptr)
+{
+    copyHandler(other);
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+StaticFunction<TRet (TArgs...), TSize>::StaticFunction(
+    StaticFunction& other)
+    : StaticFunction(static_cast<const StaticFunction&>(other))
 {
-    if (valid_) {
-        auto otherInvoker = other.getInvoker();
-        otherInvoker->copyTo(&handler_);
-    }
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 StaticFunction<TRet (TArgs...), TSize>::StaticFunction(
     StaticFunction&& other)
-    : valid_(other.valid_)
+    : ops_(nullptr)
 {
-    if (valid_) {
-        auto otherInvoker = other.getInvoker();
-        otherInvoker->moveTo(&handler_);
-        other = nullptr;
-    }
+    moveHandler(other);
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
@@ -234,12 +243,7 @@ StaticFunction<TRet (TArgs...), TSize>::operator=(const StaticFunction& other)
     }
 
     destroyHandler();
-    valid_ = other.valid_;
-    if (valid_) {
-        auto otherInvoker = other.getInvoker();
-        GASSERT(otherInvoker != nullptr);
-        otherInvoker->copyTo(&handler_);
-    }
+    copyHandler(other);
     return *this;
 }
 
@@ -259,13 +263,7 @@ StaticFunction<TRet (TArgs...), TSize>::operator=(StaticFunction&& other)
     }
 
     destroyHandler();
-    valid_ = other.valid_;
-    if (valid_) {
-        auto otherInvoker = other.getInvoker();
-        GASSERT(otherInvoker != nullptr);
-        otherInvoker->moveTo(&handler_);
-        other = nullptr;
-    }
+    moveHandler(other);
     return *this;
 }
 
@@ -274,7 +272,6 @@ StaticFunction<TRet (TArgs...), TSize>&
 StaticFunction<TRet (TArgs...), TSize>::operator=(std::nullptr_t)
 {
     destroyHandler();
-    valid_ = false;
     return *this;
 }
 
@@ -285,7 +282,6 @@ StaticFunction<TRet (TArgs...), TSize>::operator=(TFunc&& func)
 {
     destroyHandler();
     assignHandler(std::forward<TFunc>(func));
-    valid_ = true;
     return *this;
 }
 
@@ -297,117 +293,144 @@ StaticFunction<TRet (TArgs...), TSize>::operator=(
 {
     destroyHandler();
     assignHandler(std::forward<TFunc>(func));
-    valid_ = true;
     return *this;
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 StaticFunction<TRet (TArgs...), TSize>::operator bool() const
 {
-    return valid_;
+    return ops_ != nullptr;
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 bool StaticFunction<TRet (TArgs...), TSize>::operator!() const
 {
-    return !valid_;
+    return ops_ == nullptr;
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 TRet StaticFunction<TRet (TArgs...), TSize>::operator()(
     TArgs... args) const
 {
-    GASSERT(valid_);
-    auto invoker = getInvoker();
-    return invoker->exec(std::forward<TArgs>(args)...);
+    GASSERT(ops_ != nullptr);
+    return ops_->invokeConst_(&handler_, std::forward<TArgs>(args)...);
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 TRet StaticFunction<TRet (TArgs...), TSize>::operator()(
     TArgs... args)
 {
-    GASSERT(valid_);
-    auto invoker = getInvoker();
-    return invoker->exec(std::forward<TArgs>(args)...);
-}
-
-/// @cond DOCUMENT_STATIC_FUNCTION_INVOKER
-template <std::size_t TSize, typename TRet, typename... TArgs>
-StaticFunction<TRet (TArgs...), TSize>::Invoker::~Invoker()
-{
+    GASSERT(ops_ != nullptr);
+    return ops_->invoke_(&handler_, std::forward<TArgs>(args)...);
 }
 
+/// @cond DOCUMENT_STATIC_FUNCTION_OPS
 template <std::size_t TSize, typename TRet, typename... TArgs>
 template <typename TBound>
-template <typename TFunc>
-StaticFunction<TRet (TArgs...), TSize>::InvokerBound<TBound>::InvokerBound(
-    TFunc&& func)
-    : func_(std::forward<TFunc>(func))
+TRet StaticFunction<TRet (TArgs...), TSize>::invokeBound(
+    void* storage,
+    TArgs... args)
 {
+    return (*reinterpret_cast<TBound*>(storage))(std::forward<TArgs>(args)...);
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 template <typename TBound>
-StaticFunction<TRet (TArgs...), TSize>::InvokerBound<TBound>::~InvokerBound()
+TRet StaticFunction<TRet (TArgs...), TSize>::invokeBoundConst(
+    const void* storage,
+    TArgs... args)
 {
+    return (*reinterpret_cast<const TBound*>(storage))(std::forward<TArgs>(args)...);
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 template <typename TBound>
-TRet StaticFunction<TRet (TArgs...), TSize>::InvokerBound<TBound>::exec(
-    TArgs... args) const
+void StaticFunction<TRet (TArgs...), TSize>::copyBound(
+    void* to,
+    const void* from)
 {
-    return func_(std::forward<TArgs>(args)...);
+    auto funcPtr = new (to) TBound(*reinterpret_cast<const TBound*>(from));
+    static_cast<void>(funcPtr);
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 template <typename TBound>
-TRet StaticFunction<TRet (TArgs...), TSize>::InvokerBound<TBound>::exec(
-    TArgs... args)
+void StaticFunction<TRet (TArgs...), TSize>::moveBound(
+    void* to,
+    void* from)
 {
-    return func_(std::forward<TArgs>(args)...);
+    auto funcPtr = new (to) TBound(std::move(*reinterpret_cast<TBound*>(from)));
+    static_cast<void>(funcPtr);
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 template <typename TBound>
-void StaticFunction<TRet (TArgs...), TSize>::InvokerBound<TBound>::copyTo(
-    void* place) const
+void StaticFunction<TRet (TArgs...), TSize>::destroyBound(void* storage)
 {
-    auto otherInvoker = new (place) InvokerBound(*this);
-    static_cast<void>(otherInvoker);
+    reinterpret_cast<TBound*>(storage)->~TBound();
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
 template <typename TBound>
-void StaticFunction<TRet (TArgs...), TSize>::InvokerBound<TBound>::moveTo(
-    void* place)
+const typename StaticFunction<TRet (TArgs...), TSize>::Ops*
+StaticFunction<TRet (TArgs...), TSize>::getOps()
 {
-    auto otherInvoker = new (place) InvokerBound(std::move(*this));
-    static_cast<void>(otherInvoker);
+    static const bool Trivial = std::is_trivially_copyable<TBound>::value;
+    static const Ops BoundOps = {
+        &invokeBound<TBound>,
+        &invokeBoundConst<TBound>,
+        Trivial ? nullptr : &copyBound<TBound>,
+        Trivial ? nullptr : &moveBound<TBound>,
+        std::is_trivially_destructible<TBound>::value ? nullptr : &destroyBound<TBound>
+    };
+    return &BoundOps;
 }
 /// @endcond
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
-typename StaticFunction<TRet (TArgs...), TSize>::Invoker*
-StaticFunction<TRet (TArgs...), TSize>::getInvoker()
+void StaticFunction<TRet (TArgs...), TSize>::destroyHandler()
 {
-    return reinterpret_cast<Invoker*>(&handler_);
+    if ((ops_ != nullptr) && (ops_->destroy_ != nullptr)) {
+        ops_->destroy_(&handler_);
+    }
+    ops_ = nullptr;
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
-const typename StaticFunction<TRet (TArgs...), TSize>::Invoker*
-StaticFunction<TRet (TArgs...), TSize>::getInvoker() const
+void StaticFunction<TRet (TArgs...), TSize>::copyHandler(
+    const StaticFunction& other)
 {
-    return reinterpret_cast<const Invoker*>(&handler_);
+    GASSERT(ops_ == nullptr);
+    if (other.ops_ == nullptr) {
+        return;
+    }
+
+    if (other.ops_->copy_ == nullptr) {
+        handler_ = other.handler_;
+    }
+    else {
+        other.ops_->copy_(&handler_, &other.handler_);
+    }
+    ops_ = other.ops_;
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
-void StaticFunction<TRet (TArgs...), TSize>::destroyHandler()
+void StaticFunction<TRet (TArgs...), TSize>::moveHandler(
+    StaticFunction& other)
 {
-    if (valid_) {
-        auto invoker = getInvoker();
-        invoker->~Invoker();
+    GASSERT(ops_ == nullptr);
+    if (other.ops_ == nullptr) {
+        return;
+    }
+
+    if (other.ops_->move_ == nullptr) {
+        handler_ = other.handler_;
+    }
+    else {
+        other.ops_->move_(&handler_, &other.handler_);
     }
+    ops_ = other.ops_;
+    other = nullptr;
 }
 
 template <std::size_t TSize, typename TRet, typename... TArgs>
@@ -416,26 +439,23 @@ void StaticFunction<TRet (TArgs...), TSize>::assignHandler(TFunc&& func)
 {
     typedef StaticFunction<TRet (TArgs...), TSize> ThisType;
     typedef typename std::decay<TFunc>::type DecayedFuncType;
-    typedef InvokerBound<DecayedFuncType> InvokerBoundType;
 
     static_assert(!std::is_same<ThisType, DecayedFuncType>::value,
         "Wrong function invocation");
 
-    static_assert(sizeof(InvokerBoundType) <= StorageAreaSize,
+    static_assert(sizeof(DecayedFuncType) <= sizeof(StorageType),
         "Increase the TSize template argument of the StaticFucntion");
 
-    static_assert(alignof(Invoker) == alignof(InvokerBoundType),
-        "Alignment requirement for Invoker object must be the same as "
-        "alignment requirement for InvokerBoundType type object");
-
-    auto handlerPtr = new (&handler_) InvokerBoundType(std::forward<TFunc>(func));
-    static_cast<void>(handlerPtr);
+    static_assert(alignof(DecayedFuncType) <= alignof(StorageType),
+        "Alignment requirement for the functor object mustn't exceed "
+        "alignment requirement for the pointer");
 
+    GASSERT(ops_ == nullptr);
+    auto funcPtr = new (&handler_) DecayedFuncType(std::forward<TFunc>(func));
+    static_cast<void>(funcPtr);
+    ops_ = getOps<DecayedFuncType>();
 }
 
 }  // namespace util
 
 }  // namespace embxx
-
-
-
@@ -19,10 +19,13 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 #include <array>
-#include <bitset>
 #include <limits>
+#include <algorithm>
+#include <iterator>
 
 #include "embxx/util/Assert.h"
 
@@ -35,6 +38,21 @@ namespace util
 namespace details
 {
 
+template <std::size_t TSize>
+struct StaticPoolAllocatorIndex
+{
+    typedef typename std::conditional<
+        (TSize < std::numeric_limits<std::uint8_t>::max()),
+        std::uint8_t,
+        typename std::conditional<
+            (TSize < std::numeric_limits<std::uint16_t>::max()),
+            std::uint16_t,
+            std::size_t
+        >::type
+    >::type Type;
+};
+
+/// @cond DOCUMENT_STATIC_POOL_ALLOCATOR_STORAGE
 template <typename TTag, typename T, std::size_t TSize>
 struct StaticPoolAllocatorStorage
 {
@@ -44,12 +62,301 @@ struct StaticPoolAllocatorStorage
             std::alignment_of<T>::value
         >::type CellType;
 
+    typedef unsigned long WordType;
+    static const std::size_t WordBits = std::numeric_limits<WordType>::digits;
+    static const std::size_t WordsCount = (TSize + WordBits - 1) / WordBits;
+    static const WordType FullWord = ~static_cast<WordType>(0);
+
+    typedef typename StaticPoolAllocatorIndex<TSize>::Type IndexType;
+    static const IndexType InvalidIdx = static_cast<IndexType>(TSize);
+
+    // Links of the doubly linked free list are stored inside the free
+    // cells themselves, hence the free list is used only if they fit.
+    struct Links
+    {
+        IndexType prev_;
+        IndexType next_;
+    };
+
+    static const bool FreeListMode = (sizeof(Links) <= sizeof(CellType));
+    typedef std::integral_constant<bool, FreeListMode> FreeListTag;
+
+    static CellType* allocate(std::size_t num)
+    {
+        if ((num == 0) || (TSize < num)) {
+            return nullptr;
+        }
+
+        initialise(FreeListTag());
+        std::size_t idx = InvalidIdx;
+        if (num == 1U) {
+            idx = findFree(FreeListTag());
+        }
+        else {
+            idx = findFreeRun(num);
+        }
+
+        if (TSize <= idx) {
+            return nullptr;
+        }
+
+        for (auto cellIdx = idx; cellIdx < (idx + num); ++cellIdx) {
+            unlink(cellIdx, FreeListTag());
+        }
+        updateFlags(idx, num, true);
+        return &items_[idx];
+    }
+
+    static void deallocate(CellType* cell, std::size_t num)
+    {
+        auto idxTmp = std::distance(&items_[0], cell);
+        GASSERT((0 <= idxTmp) && ((static_cast<std::size_t>(idxTmp) + num) <= TSize));
+        auto idx = static_cast<std::size_t>(idxTmp);
+        GASSERT(isAllocated(idx, num));
+        updateFlags(idx, num, false);
+        for (auto cellIdx = idx; cellIdx < (idx + num); ++cellIdx) {
+            pushFree(cellIdx, FreeListTag());
+        }
+    }
+
+    static bool isAllocated(std::size_t idx, std::size_t num)
+    {
+        for (auto cellIdx = idx; cellIdx < (idx + num); ++cellIdx) {
+            if (!isAllocated(cellIdx)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     static std::array<CellType, TSize> items_;
-    static std::bitset<TSize> allocFlags_;
+    static std::array<WordType, WordsCount> allocFlags_;
+    static IndexType freeHead_;
+    static bool initialised_;
+
+private:
+    static bool isAllocated(std::size_t idx)
+    {
+        return (allocFlags_[idx / WordBits] & bitMask(idx)) != 0;
+    }
+
+    static WordType bitMask(std::size_t idx)
+    {
+        return static_cast<WordType>(1U) << (idx % WordBits);
+    }
+
+    static void updateFlags(std::size_t idx, std::size_t num, bool allocated)
+    {
+        for (auto cellIdx = idx; cellIdx < (idx + num); ++cellIdx) {
+            auto& word = allocFlags_[cellIdx / WordBits];
+            if (allocated) {
+                word |= bitMask(cellIdx);
+            }
+            else {
+                word &= ~bitMask(cellIdx);
+            }
+        }
+    }
+
+    static Links getLinks(std::size_t idx)
+    {
+        Links links;
+        std::memcpy(&links, &items_[idx], sizeof(links));
+        return links;
+    }
+
+    static void setLinks(std::size_t idx, const Links& links)
+    {
+        std::memcpy(&items_[idx], &links, sizeof(links));
+    }
+
+    static void initialise(std::true_type)
+    {
+        if (initialised_) {
+            return;
+        }
+
+        for (auto idx = 0U; idx < TSize; ++idx) {
+            Links links;
+            links.prev_ = (idx == 0U) ? InvalidIdx : static_cast<IndexType>(idx - 1);
+            links.next_ = static_cast<IndexType>(idx + 1);
+            setLinks(idx, links);
+        }
+        freeHead_ = 0;
+        initialised_ = true;
+    }
+
+    static void initialise(std::false_type)
+    {
+    }
+
+    static std::size_t findFree(std::true_type)
+    {
+        return freeHead_;
+    }
+
+    static std::size_t findFree(std::false_type)
+    {
+        for (auto wordIdx = 0U; wordIdx < WordsCount; ++wordIdx) {
+            auto word = allocFlags_[wordIdx];
+            if (word == FullWord) {
+                continue;
+            }
+
+            auto lowestZero = (~word) & (word + 1);
+            std::size_t bitIdx = 0;
+            while ((lowestZero >>= 1) != 0) {
+                ++bitIdx;
+            }
+            return (wordIdx * WordBits) + bitIdx;
+        }
+        return InvalidIdx;
+    }
+
+    static std::size_t findFreeRun(std::size_t num)
+    {
+        std::size_t runStart = 0;
+        std::size_t runLen = 0;
+        std::size_t idx = 0;
+        while (idx < TSize) {
+            auto word = allocFlags_[idx / WordBits];
+            auto isWordStart = ((idx % WordBits) == 0);
+            if (isWordStart && (word == FullWord)) {
+                runLen = 0;
+                idx += WordBits;
+                continue;
+            }
+
+            if (isWordStart && (word == 0)) {
+                if (runLen == 0) {
+                    runStart = idx;
+                }
+                auto wordCells = std::min(WordBits, TSize - idx);
+                runLen += wordCells;
+                if (num <= runLen) {
+                    return runStart;
+                }
+                idx += wordCells;
+                continue;
+            }
+
+            if ((word & bitMask(idx)) != 0) {
+                runLen = 0;
+            }
+            else {
+                if (runLen == 0) {
+                    runStart = idx;
+                }
+                ++runLen;
+                if (num <= runLen) {
+                    return runStart;
+                }
+            }
+            ++idx;
+        }
+        return InvalidIdx;
+    }
+
+    static void unlink(std::size_t idx, std::true_type)
+    {
+        auto links = getLinks(idx);
+        if (links.prev_ == InvalidIdx) {
+            GASSERT(freeHead_ == idx);
+            freeHead_ = links.next_;
+        }
+        else {
+            auto prevLinks = getLinks(links.prev_);
+            prevLinks.next_ = links.next_;
+            setLinks(links.prev_, prevLinks);
+        }
+
+        if (links.next_ != InvalidIdx) {
+            auto nextLinks = getLinks(links.next_);
+            nextLinks.prev_ = links.prev_;
+            setLinks(links.next_, nextLinks);
+        }
+    }
+
+    static void unlink(std::size_t idx, std::false_type)
+    {
+        static_cast<void>(idx);
+    }
+
+    static void pushFree(std::size_t idx, std::true_type)
+    {
+        Links links;
+        links.prev_ = InvalidIdx;
+        links.next_ = freeHead_;
+        setLinks(idx, links);
+        if (freeHead_ != InvalidIdx) {
+            auto headLinks = getLinks(freeHead_);
+            headLinks.prev_ = static_cast<IndexType>(idx);
+            setLinks(freeHead_, headLinks);
+        }
+        freeHead_ = static_cast<IndexType>(idx);
+    }
+
+    static void pushFree(std::size_t idx, std::false_type)
+    {
+        static_cast<void>(idx);
+    }
 };
+/// @endcond
+
+template <typename TTag, typename T, std::size_t TSize>
+const std::size_t StaticPoolAllocatorStorage<TTag, T, TSize>::WordBits;
+
+template <typename TTag, typename T, std::size_t TSize>
+const std::size_t StaticPoolAllocatorStorage<TTag, T, TSize>::WordsCount;
+
+template <typename TTag, typename T, std::size_t TSize>
+const typename StaticPoolAllocatorStorage<TTag, T, TSize>::WordType
+StaticPoolAllocatorStorage<TTag, T, TSize>::FullWord;
+
+template <typename TTag, typename T, std::size_t TSize>
+const typename StaticPoolAllocatorStorage<TTag, T, TSize>::IndexType
+StaticPoolAllocatorStorage<TTag, T, TSize>::InvalidIdx;
+
+template <typename TTag, typename T, std::size_t TSize>
+std::array<typename StaticPoolAllocatorStorage<TTag, T, TSize>::CellType, TSize>
+StaticPoolAllocatorStorage<TTag, T, TSize>::items_;
+
+template <typename TTag, typename T, std::size_t TSize>
+std::array<
+    typename StaticPoolAllocatorStorage<TTag, T, TSize>::WordType,
+    StaticPoolAllocatorStorage<TTag, T, TSize>::WordsCount>
+StaticPoolAllocatorStorage<TTag, T, TSize>::allocFlags_;
+
+template <typename TTag, typename T, std::size_t TSize>
+typename StaticPoolAllocatorStorage<TTag, T, TSize>::IndexType
+StaticPoolAllocatorStorage<TTag, T, TSize>::freeHead_ =
+    StaticPoolAllocatorStorage<TTag, T, TSize>::InvalidIdx;
+
+template <typename TTag, typename T, std::size_t TSize>
+bool StaticPoolAllocatorStorage<TTag, T, TSize>::initialised_ = false;
 
 }  // namespace details
 
+/// @addtogroup util
+/// @{
+
+/// @brief Allocator of the objects from the static pool.
+/// @details The pool of TSize cells, each capable of storing one object of
+///          type T, is statically allocated and shared by all the allocator
+///          objects with the same TTag, T and TSize parameters, i.e. the
+///          allocator is stateless and may be used by the STL containers,
+///          such as std::list or std::map, via rebind.
+///
+///          If the object is large enough to store two cell indices, the free
+///          cells are kept in the intrusive doubly linked list, which makes
+///          single object allocation and deallocation O(1). Allocation of
+///          multiple adjacent cells scans the allocation flags word by word,
+///          skipping the fully allocated words, and unlinks the found cells
+///          from the free list.
+/// @tparam TTag Tag type to distinguish between pools of the same object type.
+/// @tparam T Type of the allocated object.
+/// @tparam TSize Number of cells in the pool.
+/// @headerfile embxx/util/StaticPoolAllocator.h
 template <typename TTag, typename T = void, std::size_t TSize = 1>
 class StaticPoolAllocator
 {
@@ -87,82 +394,25 @@ public:
     StaticPoolAllocator& operator=(const StaticPoolAllocator&) = default;
     StaticPoolAllocator& operator=(StaticPoolAllocator&&) = default;
 
-    pointer allocate(size_type num)
+    template <typename U>
+    StaticPoolAllocator(const StaticPoolAllocator<TTag, U, TSize>&)
     {
-        if (max_size() < num) {
-            return nullptr;
-        }
-
-        auto allocBitset = numToBitset(num);
-
-        std::size_t idx = 0;
-        while (idx <= (Storage::allocFlags_.size() - num)) {
-            auto checkBitmask = Storage::allocFlags_ & allocBitset;
-            if (checkBitmask.none()) {
-                Storage::allocFlags_ |= allocBitset;
-                return &Storage::items_[idx];
-            }
+    }
 
-            allocBitset <<= 1U;
-            ++idx;
-        }
-        return nullptr;
+    pointer allocate(size_type num)
+    {
+        return reinterpret_cast<pointer>(Storage::allocate(num));
     }
 
     void deallocate(pointer ptr, size_type num)
     {
-        auto releaseBitset = numToBitset(num);
-
-        auto& items = Storage::items_;
-        auto idxTmp = std::distance(&items[0], ptr);
-        GASSERT((0 <= idxTmp) && ((idxTmp + num) < items.size()));
-        auto idx = static_cast<size_type>(idxTmp);
-        releaseBitset <<= idx;
-
-        GASSERT((Storage::allocFlags_ & releaseBitset) == releaseBitset);
-        Storage::allocFlags_ ^= releaseBitset;
+        Storage::deallocate(reinterpret_cast<typename Storage::CellType*>(ptr), num);
     }
 
     constexpr size_type max_size() const
     {
         return TSize;
     }
-
-    template< class U, class... Args >
-    void construct( U* p, Args&&... args )
-    {
-        ::new((void *)p) U(std::forward<Args>(args)...);
-    }
-
-    template< class U>
-    void destroy(U* p)
-    {
-        p->~U();
-    }
-
-private:
-    decltype(Storage::allocFlags_) numToBitset(size_type num)
-    {
-        typedef unsigned long long BitsetParamType;
-
-        static const std::size_t ChunkSize =
-            std::numeric_limits<BitsetParamType>::digits;
-
-        typedef decltype(Storage::allocFlags_) Bitset;
-        Bitset bitset;
-        auto remNum = num;
-        while (remNum >= ChunkSize) {
-            static const auto mask = ~(static_cast<BitsetParamType>(0));
-            bitset <<= ChunkSize;
-            bitset |= Bitset(mask);
-            remNum -= ChunkSize;
-        }
-
-        auto lastMask = (static_cast<BitsetParamType>(1U) << remNum) - 1;
-        bitset <<= remNum;
-        bitset |= Bitset(lastMask);
-        return bitset;
-    }
 };
 
 template <typename TTag, std::size_t TSize>
@@ -211,6 +461,8 @@ bool operator!=(
     return !(a1 == a2);
 }
 
+/// @}
+
 }  // namespace util
 
 }  // namespace embxx
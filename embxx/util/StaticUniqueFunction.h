@@ -0,0 +1,357 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/// @file embxx/util/StaticUniqueFunction.h
+/// Provides StaticUniqueFunction class.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <new>
+#include <utility>
+
+#include "embxx/util/Assert.h"
+
+namespace embxx
+{
+
+namespace util
+{
+
+/// @addtogroup util
+/// @{
+
+/// @brief Generic declaration of StaticUniqueFunction.
+/// @details This declaration doesn't have a body, see specialisation.
+/// @headerfile embxx/util/StaticUniqueFunction.h
+template <typename TSignature, std::size_t TSize = sizeof(void*) * 3>
+class StaticUniqueFunction;
+
+/// @brief Move-only single shot static function.
+/// @details Similar to embxx::util::StaticFunction, i.e. stores the functor
+///          object in place without any dynamic memory allocation. However
+///          it cannot be copied, hence the stored functor is only required
+///          to be move constructible and may capture move-only objects,
+///          such as std::unique_ptr to the message. It is intended to be
+///          used as completion handler of the asynchronous operation, which
+///          is invoked exactly once: the stored functor is destructed right
+///          after invocation and the function becomes invalid.
+///
+///          This is template specialisation of the following class definition
+///          @code
+///          // TSignature is a combination of return value an arguments: TRet(TArgs...)
+///          template <typename TSignature, std::size_t TSize = sizeof(void*) * 3>
+///          class StaticUniqueFunction;
+///          @endcode
+/// @tparam TSize Size of the space required to store provided functor.
+/// @tparam TRet Return type of the function
+/// @tparam TArgs Argument types
+/// @headerfile embxx/util/StaticUniqueFunction.h
+template <std::size_t TSize, typename TRet, typename... TArgs>
+class StaticUniqueFunction<TRet (TArgs...), TSize>
+{
+public:
+    /// @brief Result type
+    typedef TRet result_type;
+
+    static const std::size_t Size = TSize;
+
+    /// @brief Default constructor
+    StaticUniqueFunction();
+
+    /// @brief Constructs StaticUniqueFunction object out of provided functor
+    /// @pre TFunc invocation must have the same signature as StaticUniqueFunction
+    /// @pre @code sizeof(TFunc) <= TSize @endcode
+    template <typename TFunc>
+    explicit StaticUniqueFunction(TFunc&& func);
+
+    /// @brief Copy constructor is deleted
+    StaticUniqueFunction(const StaticUniqueFunction& other) = delete;
+
+    /// @brief Move constructor
+    /// @post Other function becomes invalid: @code (!other) == true @endcode
+    StaticUniqueFunction(StaticUniqueFunction&& other);
+
+    /// @brief Destructor
+    ~StaticUniqueFunction();
+
+    /// @brief Copy assignment operator is deleted
+    StaticUniqueFunction& operator=(const StaticUniqueFunction& other) = delete;
+
+    /// @brief Move assignment operator
+    /// @post Other function becomes invalid: @code (!other) == true @endcode
+    StaticUniqueFunction& operator=(StaticUniqueFunction&& other);
+
+    /// @brief Invalidates current function.
+    /// @post This function becomes invalid: @code (!(*this)) == true @endcode
+    StaticUniqueFunction& operator=(std::nullptr_t);
+
+    /// @brief Assigns new functor to current function using move semantics.
+    /// @pre TFunc invocation must have the same signature as StaticUniqueFunction
+    /// @pre @code sizeof(TFunc) <= TSize @endcode
+    /// @post This function becomes valid: @code (!(*this)) == false @endcode
+    template <typename TFunc>
+    StaticUniqueFunction& operator=(TFunc&& func);
+
+    /// @brief Boolean conversion operator.
+    /// @return Returns true if and only if current function is valid, i.e.
+    ///         may be invoked using operator().
+    operator bool() const;
+
+    /// @brief Negation operator.
+    /// @return Returns true if and only if current function is invalid, i.e.
+    ///         may NOT be invoked using operator().
+    bool operator!() const;
+
+    /// @brief Function invocation operator.
+    /// @details Invokes operator() of the stored functor with provided
+    ///          arguments and destructs it.
+    /// @return What functor returns
+    /// @pre The function object is valid, i.e. has functor assigned to it.
+    /// @post The function object is invalid, it is already invalid when
+    ///       the stored functor is being invoked. The stored functor
+    ///       is moved out of the storage area before invocation, i.e.
+    ///       it may safely assign new functor to the same object.
+    ///       If the move of the functor throws, the function object
+    ///       stays valid.
+    TRet operator()(TArgs... args);
+
+private:
+
+    /// @cond DOCUMENT_STATIC_FUNCTION_OPS
+    struct Ops
+    {
+        TRet (*invoke_)(StaticUniqueFunction& func, TArgs... args); // invoke and destroy
+        void (*move_)(void* to, void* from); // nullptr for memcpy
+        void (*destroy_)(void* storage); // nullptr for trivial destructor
+    };
+
+    template <typename TBound>
+    static TRet invokeBound(StaticUniqueFunction& func, TArgs... args);
+
+    template <typename TBound>
+    static void moveBound(void* to, void* from);
+
+    template <typename TBound>
+    static void destroyBound(void* storage);
+
+    template <typename TBound>
+    static const Ops* getOps();
+    /// @endcond
+
+    typedef typename
+        std::aligned_storage<
+            TSize,
+            std::alignment_of<void*>::value
+        >::type StorageType;
+
+    void destroyHandler();
+    void moveHandler(StaticUniqueFunction& other);
+    template <typename TFunc>
+    void assignHandler(TFunc&& func);
+
+    const Ops* ops_;
+    StorageType handler_;
+};
+
+/// @}
+
+// Implementation
+template <std::size_t TSize, typename TRet, typename... TArgs>
+StaticUniqueFunction<TRet (TArgs...), TSize>::StaticUniqueFunction()
+    : ops_(nullptr)
+{
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+template <typename TFunc>
+StaticUniqueFunction<TRet (TArgs...), TSize>::StaticUniqueFunction(TFunc&& func)
+    : ops_(nullptr)
+{
+    assignHandler(std::forward<TFunc>(func));
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+StaticUniqueFunction<TRet (TArgs...), TSize>::StaticUniqueFunction(
+    StaticUniqueFunction&& other)
+    : ops_(nullptr)
+{
+    moveHandler(other);
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+StaticUniqueFunction<TRet (TArgs...), TSize>::~StaticUniqueFunction()
+{
+    destroyHandler();
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+StaticUniqueFunction<TRet (TArgs...), TSize>&
+StaticUniqueFunction<TRet (TArgs...), TSize>::operator=(
+    StaticUniqueFunction&& other)
+{
+    if (&other == this) {
+        return *this;
+    }
+
+    destroyHandler();
+    moveHandler(other);
+    return *this;
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+StaticUniqueFunction<TRet (TArgs...), TSize>&
+StaticUniqueFunction<TRet (TArgs...), TSize>::operator=(std::nullptr_t)
+{
+    destroyHandler();
+    return *this;
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+template <typename TFunc>
+StaticUniqueFunction<TRet (TArgs...), TSize>&
+StaticUniqueFunction<TRet (TArgs...), TSize>::operator=(TFunc&& func)
+{
+    destroyHandler();
+    assignHandler(std::forward<TFunc>(func));
+    return *this;
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+StaticUniqueFunction<TRet (TArgs...), TSize>::operator bool() const
+{
+    return ops_ != nullptr;
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+bool StaticUniqueFunction<TRet (TArgs...), TSize>::operator!() const
+{
+    return ops_ == nullptr;
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+TRet StaticUniqueFunction<TRet (TArgs...), TSize>::operator()(
+    TArgs... args)
+{
+    GASSERT(ops_ != nullptr);
+    return ops_->invoke_(*this, std::forward<TArgs>(args)...);
+}
+
+/// @cond DOCUMENT_STATIC_FUNCTION_OPS
+template <std::size_t TSize, typename TRet, typename... TArgs>
+template <typename TBound>
+TRet StaticUniqueFunction<TRet (TArgs...), TSize>::invokeBound(
+    StaticUniqueFunction& func,
+    TArgs... args)
+{
+    // The stored functor may assign new one to the same function
+    // object, the storage area must be released prior to invocation.
+    // The function stays valid until the functor is successfully moved
+    // out, so the throwing move leaves it to be destroyed by the owner.
+    auto funcPtr = reinterpret_cast<TBound*>(&func.handler_);
+    TBound bound(std::move(*funcPtr));
+    funcPtr->~TBound();
+    func.ops_ = nullptr;
+    return bound(std::forward<TArgs>(args)...);
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+template <typename TBound>
+void StaticUniqueFunction<TRet (TArgs...), TSize>::moveBound(
+    void* to,
+    void* from)
+{
+    auto funcPtr = new (to) TBound(std::move(*reinterpret_cast<TBound*>(from)));
+    static_cast<void>(funcPtr);
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+template <typename TBound>
+void StaticUniqueFunction<TRet (TArgs...), TSize>::destroyBound(void* storage)
+{
+    reinterpret_cast<TBound*>(storage)->~TBound();
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+template <typename TBound>
+const typename StaticUniqueFunction<TRet (TArgs...), TSize>::Ops*
+StaticUniqueFunction<TRet (TArgs...), TSize>::getOps()
+{
+    static const Ops BoundOps = {
+        &invokeBound<TBound>,
+        std::is_trivially_copyable<TBound>::value ? nullptr : &moveBound<TBound>,
+        std::is_trivially_destructible<TBound>::value ? nullptr : &destroyBound<TBound>
+    };
+    return &BoundOps;
+}
+/// @endcond
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+void StaticUniqueFunction<TRet (TArgs...), TSize>::destroyHandler()
+{
+    if ((ops_ != nullptr) && (ops_->destroy_ != nullptr)) {
+        ops_->destroy_(&handler_);
+    }
+    ops_ = nullptr;
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+void StaticUniqueFunction<TRet (TArgs...), TSize>::moveHandler(
+    StaticUniqueFunction& other)
+{
+    GASSERT(ops_ == nullptr);
+    if (other.ops_ == nullptr) {
+        return;
+    }
+
+    if (other.ops_->move_ == nullptr) {
+        handler_ = other.handler_;
+    }
+    else {
+        other.ops_->move_(&handler_, &other.handler_);
+    }
+    ops_ = other.ops_;
+    other = nullptr;
+}
+
+template <std::size_t TSize, typename TRet, typename... TArgs>
+template <typename TFunc>
+void StaticUniqueFunction<TRet (TArgs...), TSize>::assignHandler(TFunc&& func)
+{
+    typedef StaticUniqueFunction<TRet (TArgs...), TSize> ThisType;
+    typedef typename std::decay<TFunc>::type DecayedFuncType;
+
+    static_assert(!std::is_same<ThisType, DecayedFuncType>::value,
+        "Wrong function invocation");
+
+    static_assert(sizeof(DecayedFuncType) <= sizeof(StorageType),
+        "Increase the TSize template argument of the StaticUniqueFunction");
+
+    static_assert(alignof(DecayedFuncType) <= alignof(StorageType),
+        "Alignment requirement for the functor object mustn't exceed "
+        "alignment requirement for the pointer");
+
+    GASSERT(ops_ == nullptr);
+    auto funcPtr = new (&handler_) DecayedFuncType(std::forward<TFunc>(func));
+    static_cast<void>(funcPtr);
+    ops_ = getOps<DecayedFuncType>();
+}
+
+}  // namespace util
+
+}  // namespace embxx
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <memory>
 #include <iterator>
+#include <vector>
 
 #include "embxx/comms/Message.h"
 #include "embxx/comms/MessageHandler.h"
@@ -39,8 +40,17 @@ enum MessageType {
 template <typename TTraits>
 class TestMessageHandler;
 
+// Specialise to make the test messages reference counted
 template <typename TTraits>
-class TestMessageBase : public embxx::comms::Message<TestMessageHandler<TTraits>, TTraits>
+struct TestMessageRefCountBase
+{
+    struct Type {};
+};
+
+template <typename TTraits>
+class TestMessageBase :
+    public embxx::comms::Message<TestMessageHandler<TTraits>, TTraits>,
+    public TestMessageRefCountBase<TTraits>::Type
 {
     typedef embxx::comms::Message<TestMessageHandler<TTraits>, TTraits> Base;
 public:
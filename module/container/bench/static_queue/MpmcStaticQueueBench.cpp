@@ -0,0 +1,168 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Compares throughput and push-to-pop latency of
+// embxx::container::MpmcStaticQueue against embxx::container::StaticQueue
+// protected by std::mutex. Half of the threads are producers, the other
+// half are consumers.
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include "embxx/container/StaticQueue.h"
+#include "embxx/container/MpmcStaticQueue.h"
+
+namespace
+{
+
+const std::size_t QueueSize = 1024;
+const unsigned ItemsPerProducer = 200000;
+
+typedef std::chrono::steady_clock Clock;
+
+std::uint64_t now()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count());
+}
+
+class LockedQueue
+{
+public:
+    bool pushBack(std::uint64_t value)
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (queue_.isFull()) {
+            return false;
+        }
+        queue_.pushBack(value);
+        return true;
+    }
+
+    bool popFront(std::uint64_t& value)
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (queue_.isEmpty()) {
+            return false;
+        }
+        value = queue_.front();
+        queue_.popFront();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    embxx::container::StaticQueue<std::uint64_t, QueueSize> queue_;
+};
+
+typedef embxx::container::MpmcStaticQueue<std::uint64_t, QueueSize> LockFreeQueue;
+
+struct Result
+{
+    double opsPerSecond;
+    double avgLatencyNs;
+};
+
+template <typename TQueue>
+Result measure(unsigned threadsCount)
+{
+    TQueue queue;
+    auto producersCount = threadsCount / 2;
+    auto consumersCount = threadsCount - producersCount;
+    auto total = static_cast<std::uint64_t>(producersCount) * ItemsPerProducer;
+
+    std::atomic<std::uint64_t> popped(0);
+    std::atomic<std::uint64_t> latencySum(0);
+    std::vector<std::thread> threads;
+
+    auto startTime = Clock::now();
+    for (auto idx = 0U; idx < producersCount; ++idx) {
+        threads.emplace_back(
+            [&queue]()
+            {
+                for (auto count = 0U; count < ItemsPerProducer; ++count) {
+                    while (!queue.pushBack(now())) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    for (auto idx = 0U; idx < consumersCount; ++idx) {
+        threads.emplace_back(
+            [&queue, &popped, &latencySum, total]()
+            {
+                std::uint64_t localLatency = 0;
+                std::uint64_t value = 0;
+                while (popped.load(std::memory_order_relaxed) < total) {
+                    if (!queue.popFront(value)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    localLatency += now() - value;
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+                latencySum += localLatency;
+            });
+    }
+
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    auto duration =
+        std::chrono::duration_cast<std::chrono::duration<double> >(Clock::now() - startTime);
+
+    Result result;
+    result.opsPerSecond = total / duration.count();
+    result.avgLatencyNs = static_cast<double>(latencySum.load()) / total;
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    static_cast<void>(argc);
+    static_cast<void>(argv);
+
+    std::cout << std::setw(8) << "Threads"
+              << std::setw(20) << "Mutex [op/s]"
+              << std::setw(18) << "Mutex lat [ns]"
+              << std::setw(20) << "MPMC [op/s]"
+              << std::setw(18) << "MPMC lat [ns]" << std::endl;
+
+    for (auto threadsCount : {2U, 4U, 8U, 16U}) {
+        auto locked = measure<LockedQueue>(threadsCount);
+        auto lockFree = measure<LockFreeQueue>(threadsCount);
+        std::cout << std::setw(8) << threadsCount
+                  << std::fixed << std::setprecision(0)
+                  << std::setw(20) << locked.opsPerSecond
+                  << std::setw(18) << locked.avgLatencyNs
+                  << std::setw(20) << lockFree.opsPerSecond
+                  << std::setw(18) << lockFree.avgLatencyNs
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Compares per-element cost of the main operations of
+// embxx::container::StaticQueue with power of two capacity (mask
+// arithmetic) against the neighbouring capacity (generic wrap around).
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+
+#include "embxx/container/StaticQueue.h"
+
+namespace
+{
+
+const unsigned Rounds = 2000;
+
+volatile std::uint32_t Sink = 0;
+
+typedef std::chrono::steady_clock Clock;
+
+double nsPerElement(Clock::time_point startTime, std::size_t count)
+{
+    auto duration =
+        std::chrono::duration_cast<std::chrono::duration<double, std::nano> >(
+            Clock::now() - startTime);
+    return duration.count() / count;
+}
+
+template <typename TQueue>
+void prepare(TQueue& queue)
+{
+    // Make sure the elements wrap around the end of the storage area
+    queue.clear();
+    while (queue.size() < (queue.capacity() / 2)) {
+        queue.pushBack(0U);
+    }
+    queue.popFront(queue.size());
+}
+
+template <typename TQueue>
+void report(const char* name)
+{
+    TQueue queue;
+    auto capacity = queue.capacity();
+    std::size_t total = static_cast<std::size_t>(Rounds) * capacity;
+
+    double pushTime = 0;
+    double popTime = 0;
+    double indexTime = 0;
+    double iterTime = 0;
+    for (auto round = 0U; round < Rounds; ++round) {
+        prepare(queue);
+
+        auto startTime = Clock::now();
+        for (auto idx = 0U; idx < capacity; ++idx) {
+            queue.pushBack(static_cast<std::uint32_t>(idx));
+        }
+        pushTime += nsPerElement(startTime, total);
+
+        std::uint32_t sum = 0;
+        startTime = Clock::now();
+        for (auto idx = 0U; idx < capacity; ++idx) {
+            sum += queue[(idx * 7) % capacity];
+        }
+        indexTime += nsPerElement(startTime, total);
+
+        startTime = Clock::now();
+        for (auto value : queue) {
+            sum += value;
+        }
+        iterTime += nsPerElement(startTime, total);
+
+        startTime = Clock::now();
+        while (!queue.isEmpty()) {
+            sum += queue.front();
+            queue.popFront();
+        }
+        popTime += nsPerElement(startTime, total);
+        Sink = Sink + sum;
+    }
+
+    std::cout << std::setw(10) << name
+              << std::setw(12) << capacity
+              << std::setw(14) << std::fixed << std::setprecision(2) << pushTime
+              << std::setw(14) << popTime
+              << std::setw(14) << indexTime
+              << std::setw(14) << iterTime
+              << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    static_cast<void>(argc);
+    static_cast<void>(argv);
+
+    std::cout << std::setw(10) << "Path"
+              << std::setw(12) << "Capacity"
+              << std::setw(14) << "Push [ns]"
+              << std::setw(14) << "Pop [ns]"
+              << std::setw(14) << "Index [ns]"
+              << std::setw(14) << "Iterate [ns]" << std::endl;
+
+    report<embxx::container::StaticQueue<std::uint32_t, 63> >("generic");
+    report<embxx::container::StaticQueue<std::uint32_t, 64> >("mask");
+    report<embxx::container::StaticQueue<std::uint32_t, 1023> >("generic");
+    report<embxx::container::StaticQueue<std::uint32_t, 1024> >("mask");
+    return 0;
+}
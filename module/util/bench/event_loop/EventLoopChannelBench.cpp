@@ -0,0 +1,223 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Measures cost of passing messages from producer thread to the event
+// loop: posting a handler that captures the message (the message is
+// copied into the handlers queue) versus sending it through
+// embxx::util::Channel.
+
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <array>
+#include <functional>
+#include <cstdint>
+
+#include "embxx/util/EventLoop.h"
+#include "embxx/util/Channel.h"
+
+namespace
+{
+
+class LoopLock
+{
+public:
+    void lock()
+    {
+        mutex_.lock();
+    }
+
+    void unlock()
+    {
+        mutex_.unlock();
+    }
+
+    void lockInterruptCtx()
+    {
+        lock();
+    }
+
+    void unlockInterruptCtx()
+    {
+        unlock();
+    }
+
+private:
+    std::mutex mutex_;
+};
+
+class LoopCond
+{
+public:
+    LoopCond() : notified_(false) {}
+
+    template <typename TLock>
+    void wait(TLock& lock)
+    {
+        if (!notified_) {
+            cond_.wait(lock);
+        }
+        notified_ = false;
+    }
+
+    void notify()
+    {
+        notified_ = true;
+        cond_.notify_all();
+    }
+
+private:
+    std::condition_variable_any cond_;
+    bool notified_;
+};
+
+const std::size_t LoopSize = 16 * 1024;
+const std::size_t ChannelSize = 256;
+const unsigned MsgCount = 1000000;
+
+typedef embxx::util::EventLoop<LoopSize, LoopLock, LoopCond> EventLoop;
+
+template <std::size_t TPayloadSize>
+struct Msg
+{
+    std::array<std::uint8_t, TPayloadSize> data;
+};
+
+template <typename TMsg>
+double measurePost()
+{
+    EventLoop el;
+    unsigned count = 0;
+    std::uint32_t sum = 0;
+
+    std::thread th(
+        [&el, &count, &sum]()
+        {
+            TMsg msg;
+            msg.data.fill(1);
+            for (auto idx = 0U; idx < MsgCount; ++idx) {
+                auto task =
+                    [&el, &count, &sum, msg]()
+                    {
+                        sum += msg.data[0];
+                        ++count;
+                        if (MsgCount <= count) {
+                            el.stop();
+                        }
+                    };
+
+                while (!el.post(task)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+    auto startTime = std::chrono::steady_clock::now();
+    el.run();
+    auto endTime = std::chrono::steady_clock::now();
+    th.join();
+
+    auto duration =
+        std::chrono::duration_cast<std::chrono::duration<double> >(endTime - startTime);
+    return MsgCount / duration.count();
+}
+
+template <typename TMsg>
+double measureChannel()
+{
+    typedef std::function<void (const embxx::error::ErrorStatus&)> WaitHandler;
+    typedef embxx::util::Channel<TMsg, ChannelSize, EventLoop, WaitHandler> Channel;
+
+    EventLoop el;
+    Channel channel(el);
+    unsigned count = 0;
+    std::uint32_t sum = 0;
+
+    WaitHandler handler;
+    handler =
+        [&](const embxx::error::ErrorStatus& es)
+        {
+            static_cast<void>(es);
+            count += channel.receiveBatch(
+                [&sum](TMsg&& msg)
+                {
+                    sum += msg.data[0];
+                });
+
+            if (MsgCount <= count) {
+                el.stop();
+                return;
+            }
+            channel.asyncWaitDataAvailable(std::ref(handler));
+        };
+    channel.asyncWaitDataAvailable(std::ref(handler));
+
+    std::thread th(
+        [&channel]()
+        {
+            TMsg msg;
+            msg.data.fill(1);
+            for (auto idx = 0U; idx < MsgCount; ++idx) {
+                while (!channel.send(msg)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+    auto startTime = std::chrono::steady_clock::now();
+    el.run();
+    auto endTime = std::chrono::steady_clock::now();
+    th.join();
+
+    auto duration =
+        std::chrono::duration_cast<std::chrono::duration<double> >(endTime - startTime);
+    return MsgCount / duration.count();
+}
+
+template <std::size_t TPayloadSize>
+void report()
+{
+    typedef Msg<TPayloadSize> MsgType;
+    auto posted = measurePost<MsgType>();
+    auto sent = measureChannel<MsgType>();
+    std::cout << std::setw(10) << TPayloadSize
+              << std::setw(18) << std::fixed << std::setprecision(0) << posted
+              << std::setw(18) << sent
+              << std::setw(10) << std::setprecision(2) << (sent / posted)
+              << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    static_cast<void>(argc);
+    static_cast<void>(argv);
+
+    std::cout << std::setw(10) << "Payload"
+              << std::setw(18) << "post() [msg/s]"
+              << std::setw(18) << "Channel [msg/s]"
+              << std::setw(10) << "Ratio" << std::endl;
+
+    report<8>();
+    report<64>();
+    report<256>();
+    return 0;
+}
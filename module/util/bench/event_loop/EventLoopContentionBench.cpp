@@ -0,0 +1,186 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Measures throughput of posting handlers to the event loop from several
+// producer threads. Compares embxx::util::EventLoop (every post acquires
+// the lock) in default and batched drain modes with
+// embxx::util::LockFreeEventLoop.
+
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+
+#include "embxx/util/EventLoop.h"
+#include "embxx/util/LockFreeEventLoop.h"
+
+namespace
+{
+
+class LoopLock
+{
+public:
+    void lock()
+    {
+        mutex_.lock();
+    }
+
+    void unlock()
+    {
+        mutex_.unlock();
+    }
+
+    void lockInterruptCtx()
+    {
+        lock();
+    }
+
+    void unlockInterruptCtx()
+    {
+        unlock();
+    }
+
+private:
+    std::mutex mutex_;
+};
+
+class LoopCond
+{
+public:
+    LoopCond() : notified_(false) {}
+
+    template <typename TLock>
+    void wait(TLock& lock)
+    {
+        if (!notified_) {
+            cond_.wait(lock);
+        }
+        notified_ = false;
+    }
+
+    void notify()
+    {
+        notified_ = true;
+        cond_.notify_all();
+    }
+
+private:
+    std::condition_variable_any cond_;
+    bool notified_;
+};
+
+const std::size_t LoopSize = 16 * 1024;
+const unsigned PostsPerProducer = 200000;
+
+typedef embxx::util::EventLoop<LoopSize, LoopLock, LoopCond> LockedLoop;
+typedef embxx::util::LockFreeEventLoop<LoopSize, LoopLock, LoopCond> LockFreeLoop;
+
+void setDrainBudget(LockedLoop& el, std::size_t budget)
+{
+    el.setDrainBudget(budget);
+}
+
+void setDrainBudget(LockFreeLoop& el, std::size_t budget)
+{
+    static_cast<void>(el);
+    static_cast<void>(budget);
+}
+
+template <typename TEventLoop>
+double measure(unsigned producers, std::size_t drainBudget = 1)
+{
+    TEventLoop el;
+    setDrainBudget(el, drainBudget);
+    unsigned count = 0;
+    unsigned total = producers * PostsPerProducer;
+    std::atomic<bool> start(false);
+
+    std::vector<std::thread> threads;
+    for (auto idx = 0U; idx < producers; ++idx) {
+        threads.push_back(std::thread(
+            [&el, &count, &start, total]()
+            {
+                while (!start) {
+                    std::this_thread::yield();
+                }
+
+                for (auto postIdx = 0U; postIdx < PostsPerProducer; ++postIdx) {
+                    auto task =
+                        [&el, &count, total]()
+                        {
+                            ++count;
+                            if (total <= count) {
+                                el.stop();
+                            }
+                        };
+
+                    while (!el.post(task)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    start = true;
+    el.run();
+    auto endTime = std::chrono::steady_clock::now();
+
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    auto duration =
+        std::chrono::duration_cast<std::chrono::duration<double> >(endTime - startTime);
+    return total / duration.count();
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    static_cast<void>(argc);
+    static_cast<void>(argv);
+
+    static const unsigned ProducersCounts[] = {1, 2, 4, 8};
+
+    static const std::size_t BatchedDrainBudget = 64;
+
+    std::cout << std::setw(10) << "Producers"
+              << std::setw(20) << "EventLoop [op/s]"
+              << std::setw(22) << "Batched drain [op/s]"
+              << std::setw(26) << "LockFreeEventLoop [op/s]"
+              << std::setw(10) << "Ratio" << std::endl;
+
+    for (auto producers : ProducersCounts) {
+        auto locked = measure<LockedLoop>(producers);
+        auto batched = measure<LockedLoop>(producers, BatchedDrainBudget);
+        auto lockFree = measure<LockFreeLoop>(producers);
+        std::cout << std::setw(10) << producers
+                  << std::setw(20) << std::fixed << std::setprecision(0) << locked
+                  << std::setw(22) << batched
+                  << std::setw(26) << lockFree
+                  << std::setw(10) << std::setprecision(2) << (lockFree / locked)
+                  << std::endl;
+    }
+
+    return 0;
+}
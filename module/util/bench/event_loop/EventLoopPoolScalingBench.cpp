@@ -0,0 +1,182 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Measures scaling of embxx::util::EventLoopPool with number of workers.
+// CPU bound handlers are posted by a single producer either in round-robin
+// manner or all to the same shard, in the latter case the load is
+// balanced only by work stealing.
+
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+
+#include "embxx/util/EventLoopPool.h"
+
+namespace
+{
+
+class LoopLock
+{
+public:
+    void lock()
+    {
+        mutex_.lock();
+    }
+
+    void unlock()
+    {
+        mutex_.unlock();
+    }
+
+    void lockInterruptCtx()
+    {
+        lock();
+    }
+
+    void unlockInterruptCtx()
+    {
+        unlock();
+    }
+
+private:
+    std::mutex mutex_;
+};
+
+class LoopCond
+{
+public:
+    LoopCond() : notified_(false) {}
+
+    template <typename TLock>
+    void wait(TLock& lock)
+    {
+        if (!notified_) {
+            cond_.wait(lock);
+        }
+        notified_ = false;
+    }
+
+    void notify()
+    {
+        notified_ = true;
+        cond_.notify_all();
+    }
+
+private:
+    std::condition_variable_any cond_;
+    bool notified_;
+};
+
+const std::size_t ShardSize = 16 * 1024;
+const unsigned TotalPosts = 100000;
+const unsigned WorkIterations = 2000;
+
+volatile unsigned Sink = 0;
+
+void doWork(unsigned seed)
+{
+    unsigned value = seed;
+    for (auto idx = 0U; idx < WorkIterations; ++idx) {
+        value = (value * 1103515245U) + 12345U;
+    }
+    Sink = value;
+}
+
+template <std::size_t TWorkers>
+double measure(bool sameShard)
+{
+    typedef embxx::util::EventLoopPool<ShardSize, LoopLock, LoopCond, TWorkers> Pool;
+
+    Pool pool;
+    std::atomic<unsigned> count(0);
+
+    std::vector<std::thread> workers;
+    for (auto idx = 0U; idx < TWorkers; ++idx) {
+        workers.push_back(std::thread(&Pool::runWorker, &pool, idx));
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (auto postIdx = 0U; postIdx < TotalPosts; ++postIdx) {
+        auto task =
+            [&pool, &count, postIdx]()
+            {
+                doWork(postIdx);
+                if (TotalPosts <= ++count) {
+                    pool.stop();
+                }
+            };
+
+        while (true) {
+            bool result = false;
+            if (sameShard) {
+                result = pool.post(0, task);
+            }
+            else {
+                result = pool.post(task);
+            }
+
+            if (result) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& th : workers) {
+        th.join();
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    auto duration =
+        std::chrono::duration_cast<std::chrono::duration<double> >(endTime - startTime);
+    return TotalPosts / duration.count();
+}
+
+template <std::size_t TWorkers>
+void report()
+{
+    auto roundRobin = measure<TWorkers>(false);
+    auto sameShard = measure<TWorkers>(true);
+    std::cout << std::setw(10) << TWorkers
+              << std::setw(24) << std::fixed << std::setprecision(0) << roundRobin
+              << std::setw(24) << sameShard << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    static_cast<void>(argc);
+    static_cast<void>(argv);
+
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::setw(10) << "Workers"
+              << std::setw(24) << "Round-robin [op/s]"
+              << std::setw(24) << "Same shard [op/s]" << std::endl;
+
+    report<1>();
+    report<2>();
+    report<4>();
+    report<8>();
+    report<16>();
+    return 0;
+}
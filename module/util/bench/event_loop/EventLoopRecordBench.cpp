@@ -0,0 +1,199 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Measures per-handler overhead of embxx::util::EventLoop: number of bytes
+// of the event loop storage consumed by a single handler and single
+// threaded throughput of posting and executing the handlers.
+
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <array>
+#include <cstdint>
+
+#include "embxx/util/EventLoop.h"
+
+namespace
+{
+
+class LoopLock
+{
+public:
+    void lock()
+    {
+        mutex_.lock();
+    }
+
+    void unlock()
+    {
+        mutex_.unlock();
+    }
+
+    void lockInterruptCtx()
+    {
+        lock();
+    }
+
+    void unlockInterruptCtx()
+    {
+        unlock();
+    }
+
+private:
+    std::mutex mutex_;
+};
+
+class LoopCond
+{
+public:
+    LoopCond() : notified_(false) {}
+
+    template <typename TLock>
+    void wait(TLock& lock)
+    {
+        if (!notified_) {
+            cond_.wait(lock);
+        }
+        notified_ = false;
+    }
+
+    void notify()
+    {
+        notified_ = true;
+        cond_.notify_all();
+    }
+
+private:
+    std::condition_variable_any cond_;
+    bool notified_;
+};
+
+const std::size_t LoopSize = 4096;
+const unsigned Rounds = 20000;
+
+typedef embxx::util::EventLoop<LoopSize, LoopLock, LoopCond> EventLoop;
+
+volatile unsigned Sink = 0;
+
+template <std::size_t TCaptureSize>
+class Handler
+{
+public:
+    Handler()
+    {
+        data_.fill(1);
+    }
+
+    void operator()() const
+    {
+        Sink = Sink + data_[0];
+    }
+
+private:
+    std::array<std::uint8_t, TCaptureSize> data_;
+};
+
+class EmptyHandler
+{
+public:
+    void operator()() const
+    {
+        Sink = Sink + 1;
+    }
+};
+
+template <typename THandler>
+double bytesPerHandler()
+{
+    EventLoop el;
+    unsigned count = 0;
+    while (el.post(THandler())) {
+        ++count;
+    }
+    return static_cast<double>(LoopSize) / count;
+}
+
+template <typename THandler>
+double handlersPerSecond(std::size_t drainBudget)
+{
+    EventLoop el;
+    el.setDrainBudget(drainBudget);
+
+    unsigned capacity = 0;
+    while (el.post(THandler())) {
+        ++capacity;
+    }
+    el.reset();
+
+    unsigned total = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (auto round = 0U; round < Rounds; ++round) {
+        for (auto idx = 1U; idx < capacity; ++idx) {
+            el.post(THandler());
+        }
+
+        el.post(
+            [&el]()
+            {
+                el.stop();
+            });
+
+        el.run();
+        el.reset();
+        total += capacity;
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    auto duration =
+        std::chrono::duration_cast<std::chrono::duration<double> >(endTime - startTime);
+    return total / duration.count();
+}
+
+template <typename THandler>
+void report(const char* name)
+{
+    std::cout << std::setw(14) << name
+              << std::setw(16) << std::fixed << std::setprecision(1)
+              << bytesPerHandler<THandler>()
+              << std::setw(22) << std::setprecision(0)
+              << handlersPerSecond<THandler>(1)
+              << std::setw(22) << handlersPerSecond<THandler>(0)
+              << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    static_cast<void>(argc);
+    static_cast<void>(argv);
+
+    std::cout << std::setw(14) << "Capture"
+              << std::setw(16) << "Bytes/handler"
+              << std::setw(22) << "Budget 1 [op/s]"
+              << std::setw(22) << "Unlimited [op/s]" << std::endl;
+
+    report<EmptyHandler>("empty");
+    report<Handler<4> >("4 bytes");
+    report<Handler<8> >("8 bytes");
+    report<Handler<12> >("12 bytes");
+    report<Handler<24> >("24 bytes");
+    report<Handler<40> >("40 bytes");
+    return 0;
+}
@@ -0,0 +1,238 @@
+//
+// Copyright 2014 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Measures throughput of single object allocation / deallocation from the
+// static pool by several threads. Compares std::mutex protected
+// embxx::util::StaticPoolAllocator with
+// embxx::util::LockFreeStaticPoolAllocator in two scenarios: every thread
+// releases its own objects, and producer threads allocate objects that
+// are released by single consumer thread (like the event loop thread).
+
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+
+#include "embxx/util/StaticPoolAllocator.h"
+#include "embxx/util/LockFreeStaticPoolAllocator.h"
+#include "embxx/container/MpmcStaticQueue.h"
+
+namespace
+{
+
+struct Object
+{
+    unsigned data_[8];
+};
+
+const std::size_t PoolSize = 1024;
+const unsigned OpsPerThread = 500000;
+const unsigned BatchSize = 4;
+const std::size_t QueueSize = 256;
+
+struct PoolTag {};
+
+class LockedAllocator
+{
+    typedef embxx::util::StaticPoolAllocator<PoolTag, Object, PoolSize> Allocator;
+public:
+    Object* allocate()
+    {
+        std::lock_guard<std::mutex> guard(mutex());
+        return Allocator().allocate(1);
+    }
+
+    void deallocate(Object* obj)
+    {
+        std::lock_guard<std::mutex> guard(mutex());
+        Allocator().deallocate(obj, 1);
+    }
+
+private:
+    static std::mutex& mutex()
+    {
+        static std::mutex Mutex;
+        return Mutex;
+    }
+};
+
+class LockFreeAllocator
+{
+    typedef embxx::util::LockFreeStaticPoolAllocator<PoolTag, Object, PoolSize> Allocator;
+public:
+    Object* allocate()
+    {
+        return Allocator().allocate(1);
+    }
+
+    void deallocate(Object* obj)
+    {
+        Allocator().deallocate(obj, 1);
+    }
+};
+
+template <typename TAllocator>
+Object* allocateWait(TAllocator& allocator)
+{
+    while (true) {
+        auto* obj = allocator.allocate();
+        if (obj != nullptr) {
+            return obj;
+        }
+        std::this_thread::yield();
+    }
+}
+
+template <typename TAllocator>
+double measureLocal(unsigned threadsCount)
+{
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for (auto idx = 0U; idx < threadsCount; ++idx) {
+        threads.push_back(std::thread(
+            [&start]()
+            {
+                TAllocator allocator;
+                while (!start) {
+                    std::this_thread::yield();
+                }
+
+                Object* objs[BatchSize] = {nullptr};
+                for (auto opIdx = 0U; opIdx < OpsPerThread; opIdx += BatchSize) {
+                    for (auto& obj : objs) {
+                        obj = allocateWait(allocator);
+                        obj->data_[0] = opIdx;
+                    }
+
+                    for (auto* obj : objs) {
+                        allocator.deallocate(obj);
+                    }
+                }
+            }));
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    start = true;
+    for (auto& th : threads) {
+        th.join();
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    auto duration =
+        std::chrono::duration_cast<std::chrono::duration<double> >(endTime - startTime);
+    return (threadsCount * OpsPerThread) / duration.count();
+}
+
+template <typename TAllocator>
+double measureCrossThread(unsigned producers)
+{
+    typedef embxx::container::MpmcStaticQueue<Object*, QueueSize> Queue;
+    Queue queue;
+    std::atomic<bool> start(false);
+    unsigned total = producers * OpsPerThread;
+
+    std::vector<std::thread> threads;
+    for (auto idx = 0U; idx < producers; ++idx) {
+        threads.push_back(std::thread(
+            [&start, &queue]()
+            {
+                TAllocator allocator;
+                while (!start) {
+                    std::this_thread::yield();
+                }
+
+                for (auto opIdx = 0U; opIdx < OpsPerThread; ++opIdx) {
+                    auto* obj = allocateWait(allocator);
+                    obj->data_[0] = opIdx;
+                    while (!queue.pushBack(obj)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    start = true;
+
+    TAllocator allocator;
+    for (auto count = 0U; count < total;) {
+        Object* obj = nullptr;
+        if (!queue.popFront(obj)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        allocator.deallocate(obj);
+        ++count;
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    auto duration =
+        std::chrono::duration_cast<std::chrono::duration<double> >(endTime - startTime);
+    return total / duration.count();
+}
+
+typedef double (*MeasureFunc)(unsigned);
+
+void report(const char* title, MeasureFunc lockedFunc, MeasureFunc lockFreeFunc)
+{
+    static const unsigned ThreadsCounts[] = {1, 2, 4, 8};
+
+    std::cout << title << std::endl;
+    std::cout << std::setw(10) << "Threads"
+              << std::setw(20) << "Mutex [op/s]"
+              << std::setw(20) << "Lock-free [op/s]"
+              << std::setw(10) << "Ratio" << std::endl;
+
+    for (auto threadsCount : ThreadsCounts) {
+        auto locked = lockedFunc(threadsCount);
+        auto lockFree = lockFreeFunc(threadsCount);
+        std::cout << std::setw(10) << threadsCount
+                  << std::setw(20) << std::fixed << std::setprecision(0) << locked
+                  << std::setw(20) << lockFree
+                  << std::setw(10) << std::setprecision(2) << (lockFree / locked)
+                  << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[])
+{
+    static_cast<void>(argc);
+    static_cast<void>(argv);
+
+    report(
+        "Allocation and deallocation by the same thread:",
+        &measureLocal<LockedAllocator>,
+        &measureLocal<LockFreeAllocator>);
+
+    report(
+        "Allocation by producer threads, deallocation by single consumer:",
+        &measureCrossThread<LockedAllocator>,
+        &measureCrossThread<LockFreeAllocator>);
+
+    return 0;
+}